@@ -176,21 +176,16 @@ void loop()
 
       for (int i = 0; i < NUM_PACKETS_TO_SEND; i++)
       {
-        // キューがいっぱいの場合は、空きができるまで待機します
-        while (modem.isQueueFull())
-        {
-          modem.Work(); // 待機中もモデムの処理を進める必要があります
-        }
-
         // バッファにデータをセット
         snprintf(messageBuffers[i], sizeof(messageBuffers[i]), "Cont Pkt #%d", i + 1);
 
-        // TransmitDataAsync()を使用して、コマンドをキューに入れ、非同期に送信します。
-        MU_Modem_Error tx_err = modem.TransmitDataAsync((const uint8_t *)messageBuffers[i], strlen(messageBuffers[i]));
+        // TransmitDataAsyncWait()を使用して、コマンドをキューに入れ、非同期に送信します。
+        // キューがいっぱいの場合は、空きができるまで(最大1秒)内部でWork()を呼びながら待機します。
+        MU_Modem_Error tx_err = modem.TransmitDataAsyncWait((const uint8_t *)messageBuffers[i], strlen(messageBuffers[i]), 1000);
 
         if (tx_err == MU_Modem_Error::Ok)
         {
-          Serial.printf("   Packet %d: 送信コマンド受付成功 (\"%s\") [Queue: %d]\n", i + 1, messageBuffers[i], modem.getQueueCount());
+          Serial.printf("   Packet %d: 送信コマンド受付成功 (\"%s\") [Free slots: %d]\n", i + 1, messageBuffers[i], modem.GetTxFreeSlots());
         }
         else
         {
@@ -0,0 +1,83 @@
+//
+// compress_bench.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+// Compression ratio of MU_Compressor against the CPU time it takes, for typical
+// JSON telemetry with and without a shared static dictionary, plus the air time
+// the saved bytes are worth on the 429 MHz model.
+//
+// Build and run on a PC from the repository root (needs the src/common submodule):
+//   g++ -std=c++17 -O2 -I extras/benchmark/host -I src
+//       extras/benchmark/compress_bench.cpp src/MU_Compressor.cpp -o compress_bench
+//   ./compress_bench
+// CPU times are those of the PC; expect roughly two orders of magnitude more on an MCU.
+
+#include "MU_Compressor.h"
+#include "MU_Modem.h"
+#include <chrono>
+#include <stdio.h>
+
+static constexpr int ITERATIONS = 2000;
+
+static const char s_dictionary[] = "{\"id\":,\"temp\":,\"hum\":,\"bat\":,\"ts\":,\"status\":\"ok\"}";
+
+static const char *const s_samples[] = {
+    "{\"id\":12,\"temp\":23.5,\"hum\":41,\"bat\":3.71,\"ts\":1718000000,\"status\":\"ok\"}",
+    "{\"id\":12,\"temp\":23.5,\"hum\":41,\"bat\":3.71,\"ts\":1718000000,\"status\":\"ok\"},"
+    "{\"id\":13,\"temp\":23.7,\"hum\":40,\"bat\":3.70,\"ts\":1718000005,\"status\":\"ok\"},"
+    "{\"id\":14,\"temp\":22.9,\"hum\":44,\"bat\":3.69,\"ts\":1718000010,\"status\":\"ok\"}",
+};
+
+static double elapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    printf("raw  dict  packed  ratio  compress [us]  decompress [us]  air saved [ms]\n");
+    for (const char *pSample : s_samples)
+    {
+        const uint8_t *pIn = (const uint8_t *)pSample;
+        uint16_t len = (uint16_t)strlen(pSample);
+        for (int withDict = 0; withDict < 2; withDict++)
+        {
+            const uint8_t *pDict = withDict ? (const uint8_t *)s_dictionary : nullptr;
+            uint16_t dictLen = withDict ? (uint16_t)(sizeof(s_dictionary) - 1) : 0;
+            uint8_t packed[MU_MAX_PAYLOAD_LEN];
+            uint8_t restored[MU_MAX_PAYLOAD_LEN];
+
+            uint16_t packedLen = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < ITERATIONS; i++)
+                packedLen = MU_Compressor::Compress(pIn, len, packed, len, pDict, dictLen);
+            double compressUs = elapsedUs(start) / ITERATIONS;
+
+            int32_t restoredLen = -1;
+            double decompressUs = 0;
+            if (packedLen > 0)
+            {
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < ITERATIONS; i++)
+                    restoredLen = MU_Compressor::Decompress(packed, packedLen, restored, sizeof(restored), pDict, dictLen);
+                decompressUs = elapsedUs(start) / ITERATIONS;
+                if (restoredLen != len || memcmp(restored, pIn, len) != 0)
+                {
+                    printf("round trip failed\n");
+                    return 1;
+                }
+            }
+
+            // On the wire a compressed frame carries the 2-byte codec header; one that does not shrink goes out raw
+            uint16_t wireLen = packedLen ? packedLen + 2 : len;
+            if (wireLen > len)
+                wireLen = len;
+            double savedMs = (double)(len - wireLen) * MU_AIRTIME_BYTE_US_429 / 1000;
+            printf("%3u  %-4s  %6u  %5.2f  %13.2f  %15.2f  %14.1f\n", len, withDict ? "yes" : "no", wireLen,
+                   (double)wireLen / len, compressUs, decompressUs, savedMs);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// frag_goodput.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+// Goodput of MU_Fragmenter against the frame loss rate, without and with FEC.
+// One sender broadcasts a message to one receiver over a simulated channel that
+// drops every frame independently with the given probability.
+//
+// Build and run on a PC from the repository root (needs the src/common submodule):
+//   g++ -std=c++17 -O2 -I extras/benchmark/host -I src -D MU_FRAG_ARENA_SIZE=8192
+//       extras/benchmark/frag_goodput.cpp src/MU_Fragmenter.cpp -o frag_goodput
+//   ./frag_goodput
+
+#include "host/HostModem.h"
+#include "MU_Fragmenter.h"
+#include <stdio.h>
+
+static constexpr uint32_t MESSAGE_LEN = 4000;
+static constexpr int TRIALS = 500;
+
+static bool s_received;
+static bool s_sent;
+
+static void onFragEvent(const MU_Fragmenter_Event &ev)
+{
+    if (ev.type == MU_Fragmenter_EventType::Received)
+        s_received = true;
+    else if (ev.type == MU_Fragmenter_EventType::SendComplete || ev.type == MU_Fragmenter_EventType::SendFailed)
+        s_sent = true;
+}
+
+// Sends one message and returns the air time it took [us]; *pDelivered tells whether it was reassembled
+static uint64_t runTrial(uint8_t k, uint8_t m, int lossPct, const uint8_t *pMessage, bool *pDelivered)
+{
+    MU_Modem &modem = hostModem();
+    static MU_Fragmenter tx, rx;
+    tx.begin(modem, 0x01, onFragEvent);
+    rx.begin(modem, 0x02, onFragEvent);
+    tx.SetFec(k, m);
+
+    s_received = false;
+    s_sent = false;
+    hostTxQueue.clear();
+    tx.Send(pMessage, MESSAGE_LEN);
+
+    uint64_t airUs = 0;
+    while (!s_sent)
+    {
+        if (hostTxQueue.empty())
+        {
+            tx.OnModemWork(modem);
+            if (hostTxQueue.empty())
+                break;
+            continue;
+        }
+        HostFrame frame = hostTxQueue.front();
+        hostTxQueue.erase(hostTxQueue.begin());
+        airUs += hostAirTimeUs(frame.len);
+        hostMillisNow += hostAirTimeUs(frame.len) / 1000;
+
+        if (rand() % 100 >= lossPct)
+        {
+            MU_Modem_Event rxEv(MU_Modem_Error::Ok, MU_Modem_Response::DataReceived);
+            rxEv.pPayload = frame.pMsg;
+            rxEv.payloadLen = frame.len;
+            rx.OnModemEvent(modem, rxEv);
+        }
+        MU_Modem_Event txEv(MU_Modem_Error::Ok, MU_Modem_Response::TxComplete);
+        txEv.pPayload = frame.pMsg;
+        txEv.payloadLen = frame.len;
+        tx.OnModemEvent(modem, txEv);
+    }
+
+    // Let an incomplete message time out before the next trial reuses the arena
+    hostMillisNow += MU_FRAG_REASSEMBLY_TIMEOUT_MS + 1;
+    rx.OnModemWork(modem);
+    *pDelivered = s_received;
+    return airUs;
+}
+
+int main()
+{
+    static uint8_t message[MESSAGE_LEN];
+    for (uint32_t i = 0; i < MESSAGE_LEN; i++)
+        message[i] = (uint8_t)rand();
+
+    static const uint8_t configs[][2] = {{0, 0}, {8, 2}, {8, 4}};
+    static const int lossRates[] = {0, 1, 5, 10, 20, 30};
+
+    printf("%u-byte message, %d trials per point, goodput = delivered bytes / air time\n", (unsigned)MESSAGE_LEN, TRIALS);
+    printf("loss%%  FEC       delivered  goodput [B/s]\n");
+    for (int loss : lossRates)
+    {
+        for (const auto &config : configs)
+        {
+            srand(1234);
+            int delivered = 0;
+            uint64_t airUs = 0;
+            for (int t = 0; t < TRIALS; t++)
+            {
+                bool ok;
+                airUs += runTrial(config[0], config[1], loss, message, &ok);
+                delivered += ok;
+            }
+            double goodput = (double)delivered * MESSAGE_LEN / (airUs / 1e6);
+            char fec[16];
+            if (config[1])
+                snprintf(fec, sizeof(fec), "(%u, %u)", config[0], config[1]);
+            else
+                snprintf(fec, sizeof(fec), "none");
+            printf("%4d   %-8s  %6.1f %%   %8.0f\n", loss, fec, 100.0 * delivered / TRIALS, goodput);
+        }
+    }
+    return 0;
+}
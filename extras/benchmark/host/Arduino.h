@@ -0,0 +1,58 @@
+//
+// Arduino.h (host build of the benchmarks)
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+// Just enough of the Arduino core to compile the library sources on a PC.
+// The clock is simulated: benchmarks advance hostMillisNow themselves.
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *pData, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            write(pData[i]);
+        return len;
+    }
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t println(const char *s) { return print(s) + print("\r\n"); }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+    virtual int availableForWrite() { return 0; }
+};
+
+inline uint32_t hostMillisNow = 0;
+
+inline uint32_t millis() { return hostMillisNow; }
+inline uint32_t micros() { return hostMillisNow * 1000; }
+inline void delay(uint32_t ms) { hostMillisNow += ms; }
+inline void yield() {}
+inline long random(long max) { return max > 0 ? rand() % max : 0; }
+inline long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline void digitalWrite(uint8_t, uint8_t) {}
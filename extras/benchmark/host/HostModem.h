@@ -0,0 +1,67 @@
+//
+// HostModem.h (host build of the benchmarks)
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+// Stands in for the MU_Modem calls the protocol layers make, so a layer can be
+// driven on a PC without a modem or SerialModemBase. Transmitted frames are
+// collected in hostTxQueue; the benchmark decides which of them arrive.
+// The MU_Modem object itself is never constructed: the layers only use the
+// methods defined here.
+
+#pragma once
+#include "MU_Modem.h"
+#include <vector>
+
+struct HostFrame
+{
+    const uint8_t *pMsg;
+    uint8_t len;
+};
+
+static std::vector<HostFrame> hostTxQueue;
+
+MU_Modem_Error MU_Modem::TransmitDataAsync(const uint8_t *pMsg, uint8_t len, bool useRouteRegister, MU_Modem_Priority priority)
+{
+    (void)useRouteRegister;
+    (void)priority;
+    hostTxQueue.push_back({pMsg, len});
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::AttachLayer(MU_Modem_Layer *pLayer)
+{
+    (void)pLayer;
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::DetachLayer(MU_Modem_Layer *pLayer)
+{
+    (void)pLayer;
+}
+
+// No encryption or link tag on the host: every frame may be full size
+uint8_t MU_Modem::GetMaxPayloadLen() const
+{
+    return MU_MAX_PAYLOAD_LEN;
+}
+
+uint8_t MU_Modem_Layer::GetLayerFrameLen(const MU_Modem &modem)
+{
+    (void)modem;
+    return MU_LAYER_PAYLOAD_LEN;
+}
+
+// Storage for the modem reference the layers are attached to
+static MU_Modem &hostModem()
+{
+    alignas(MU_Modem) static uint8_t storage[sizeof(MU_Modem)];
+    return *reinterpret_cast<MU_Modem *>(storage);
+}
+
+// Air time of a frame of len payload bytes on the 429 MHz model [us]
+static uint32_t hostAirTimeUs(uint8_t len)
+{
+    return (uint32_t)(len + MU_AIRTIME_OVERHEAD_BYTES) * MU_AIRTIME_BYTE_US_429;
+}
@@ -0,0 +1,193 @@
+//
+// MU_AesCcm.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_AesCcm.h"
+#include <string.h>
+
+static constexpr uint8_t AES_BLOCK_LEN = 16;
+static constexpr uint8_t AES_ROUNDS = 10;
+static constexpr uint8_t CCM_L = 2; // Length field size: messages up to 65535 bytes
+
+static const uint8_t AES_SBOX[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+
+static inline uint8_t aesXtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+void MU_AesCcm::SetKey(const uint8_t *pKey)
+{
+    memcpy(m_roundKeys, pKey, MU_AES_KEY_LEN);
+
+    uint8_t rcon = 0x01;
+    for (uint8_t i = MU_AES_KEY_LEN; i < sizeof(m_roundKeys); i += 4)
+    {
+        uint8_t t[4];
+        memcpy(t, &m_roundKeys[i - 4], 4);
+        if (i % MU_AES_KEY_LEN == 0)
+        {
+            // RotWord, SubWord, Rcon
+            uint8_t first = t[0];
+            t[0] = AES_SBOX[t[1]] ^ rcon;
+            t[1] = AES_SBOX[t[2]];
+            t[2] = AES_SBOX[t[3]];
+            t[3] = AES_SBOX[first];
+            rcon = aesXtime(rcon);
+        }
+        for (uint8_t j = 0; j < 4; j++)
+            m_roundKeys[i + j] = m_roundKeys[i + j - MU_AES_KEY_LEN] ^ t[j];
+    }
+}
+
+void MU_AesCcm::EncryptBlock(uint8_t *s) const
+{
+    for (uint8_t i = 0; i < AES_BLOCK_LEN; i++)
+        s[i] ^= m_roundKeys[i];
+
+    for (uint8_t round = 1; round <= AES_ROUNDS; round++)
+    {
+        // SubBytes + ShiftRows (state is column-major: s[col * 4 + row])
+        uint8_t t[AES_BLOCK_LEN];
+        for (uint8_t col = 0; col < 4; col++)
+        {
+            for (uint8_t row = 0; row < 4; row++)
+                t[col * 4 + row] = AES_SBOX[s[((col + row) % 4) * 4 + row]];
+        }
+
+        if (round < AES_ROUNDS)
+        {
+            // MixColumns
+            for (uint8_t col = 0; col < 4; col++)
+            {
+                uint8_t *c = &t[col * 4];
+                uint8_t all = c[0] ^ c[1] ^ c[2] ^ c[3];
+                uint8_t first = c[0];
+                c[0] ^= all ^ aesXtime(c[0] ^ c[1]);
+                c[1] ^= all ^ aesXtime(c[1] ^ c[2]);
+                c[2] ^= all ^ aesXtime(c[2] ^ c[3]);
+                c[3] ^= all ^ aesXtime(c[3] ^ first);
+            }
+        }
+
+        const uint8_t *pRoundKey = &m_roundKeys[round * AES_BLOCK_LEN];
+        for (uint8_t i = 0; i < AES_BLOCK_LEN; i++)
+            s[i] = t[i] ^ pRoundKey[i];
+    }
+}
+
+void MU_AesCcm::m_ComputeTag(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pMsg,
+                             uint16_t len, uint8_t tagLen, uint8_t *pMac) const
+{
+    // B0: flags | nonce | message length
+    pMac[0] = (uint8_t)((aadLen ? 0x40 : 0x00) | (((tagLen - 2) / 2) << 3) | (CCM_L - 1));
+    memcpy(&pMac[1], pNonce, MU_CCM_NONCE_LEN);
+    pMac[14] = (uint8_t)(len >> 8);
+    pMac[15] = (uint8_t)len;
+    EncryptBlock(pMac);
+
+    // Associated data, prefixed with its 2-byte length and zero padded
+    if (aadLen)
+    {
+        pMac[0] ^= (uint8_t)(aadLen >> 8);
+        pMac[1] ^= (uint8_t)aadLen;
+        uint8_t pos = 2;
+        for (uint16_t i = 0; i < aadLen; i++)
+        {
+            pMac[pos++] ^= pAad[i];
+            if (pos == AES_BLOCK_LEN)
+            {
+                EncryptBlock(pMac);
+                pos = 0;
+            }
+        }
+        if (pos)
+            EncryptBlock(pMac);
+    }
+
+    // Message, zero padded
+    for (uint16_t i = 0; i < len; i += AES_BLOCK_LEN)
+    {
+        uint16_t n = (len - i < AES_BLOCK_LEN) ? (len - i) : AES_BLOCK_LEN;
+        for (uint16_t j = 0; j < n; j++)
+            pMac[j] ^= pMsg[i + j];
+        EncryptBlock(pMac);
+    }
+}
+
+void MU_AesCcm::m_Ctr(const uint8_t *pNonce, const uint8_t *pIn, uint8_t *pOut, uint16_t len) const
+{
+    // Counter blocks A_i for i >= 1; A_0 is reserved for the tag
+    uint16_t counter = 1;
+    for (uint16_t i = 0; i < len; i += AES_BLOCK_LEN, counter++)
+    {
+        uint8_t ks[AES_BLOCK_LEN];
+        ks[0] = CCM_L - 1;
+        memcpy(&ks[1], pNonce, MU_CCM_NONCE_LEN);
+        ks[14] = (uint8_t)(counter >> 8);
+        ks[15] = (uint8_t)counter;
+        EncryptBlock(ks);
+
+        uint16_t n = (len - i < AES_BLOCK_LEN) ? (len - i) : AES_BLOCK_LEN;
+        for (uint16_t j = 0; j < n; j++)
+            pOut[i + j] = pIn[i + j] ^ ks[j];
+    }
+}
+
+void MU_AesCcm::Encrypt(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pIn,
+                        uint8_t *pOut, uint16_t len, uint8_t *pTag, uint8_t tagLen) const
+{
+    uint8_t mac[AES_BLOCK_LEN];
+    m_ComputeTag(pNonce, pAad, aadLen, pIn, len, tagLen, mac);
+    m_Ctr(pNonce, pIn, pOut, len);
+
+    uint8_t s0[AES_BLOCK_LEN];
+    s0[0] = CCM_L - 1;
+    memcpy(&s0[1], pNonce, MU_CCM_NONCE_LEN);
+    s0[14] = 0;
+    s0[15] = 0;
+    EncryptBlock(s0);
+    for (uint8_t i = 0; i < tagLen; i++)
+        pTag[i] = mac[i] ^ s0[i];
+}
+
+bool MU_AesCcm::Decrypt(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pIn,
+                        uint8_t *pOut, uint16_t len, const uint8_t *pTag, uint8_t tagLen) const
+{
+    m_Ctr(pNonce, pIn, pOut, len);
+
+    uint8_t mac[AES_BLOCK_LEN];
+    m_ComputeTag(pNonce, pAad, aadLen, pOut, len, tagLen, mac);
+
+    uint8_t s0[AES_BLOCK_LEN];
+    s0[0] = CCM_L - 1;
+    memcpy(&s0[1], pNonce, MU_CCM_NONCE_LEN);
+    s0[14] = 0;
+    s0[15] = 0;
+    EncryptBlock(s0);
+
+    // Constant-time comparison
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < tagLen; i++)
+        diff |= (uint8_t)(mac[i] ^ s0[i] ^ pTag[i]);
+    return diff == 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file MU_AesCcm.h
+ * @brief AES-128-CCM authenticated encryption for MU frame payloads.
+ *
+ * Compact, table-light AES-128 (encryption direction only, as CCM needs) with
+ * the key schedule expanded once in SetKey(). Encryption and decryption work
+ * in place and support the truncated tags of RFC 3610 (4 to 16 bytes).
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include <Arduino.h>
+
+static constexpr uint8_t MU_AES_KEY_LEN = 16;   //!< AES-128 key length
+static constexpr uint8_t MU_CCM_NONCE_LEN = 13; //!< CCM nonce length (L = 2)
+
+/**
+ * @class MU_AesCcm
+ * @brief AES-128-CCM (RFC 3610) with a precomputed key schedule.
+ */
+class MU_AesCcm
+{
+public:
+    /**
+     * @brief Expands the key. Must be called before Encrypt()/Decrypt().
+     * @param pKey 16-byte key.
+     */
+    void SetKey(const uint8_t *pKey);
+
+    /**
+     * @brief Encrypts and authenticates a message.
+     * @param pNonce 13-byte nonce. Must never repeat under the same key.
+     * @param pAad Additional data that is authenticated but not encrypted.
+     * @param aadLen Length of the additional data.
+     * @param pIn Plaintext.
+     * @param pOut Ciphertext output (may equal pIn).
+     * @param len Length of the message.
+     * @param pTag Output of the authentication tag.
+     * @param tagLen Tag length: 4, 6, 8, 10, 12, 14 or 16.
+     */
+    void Encrypt(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pIn, uint8_t *pOut,
+                 uint16_t len, uint8_t *pTag, uint8_t tagLen) const;
+
+    /**
+     * @brief Decrypts a message and verifies its tag.
+     * @param pNonce 13-byte nonce used for encryption.
+     * @param pAad Additional data.
+     * @param aadLen Length of the additional data.
+     * @param pIn Ciphertext.
+     * @param pOut Plaintext output (may equal pIn). Contents are undefined if verification fails.
+     * @param len Length of the message.
+     * @param pTag Received tag.
+     * @param tagLen Tag length.
+     * @return True if the tag is valid.
+     */
+    bool Decrypt(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pIn, uint8_t *pOut,
+                 uint16_t len, const uint8_t *pTag, uint8_t tagLen) const;
+
+    /**
+     * @brief Encrypts one 16-byte block in place with the expanded key.
+     * @param pBlock Block to encrypt.
+     */
+    void EncryptBlock(uint8_t *pBlock) const;
+
+private:
+    void m_ComputeTag(const uint8_t *pNonce, const uint8_t *pAad, uint16_t aadLen, const uint8_t *pMsg, uint16_t len,
+                      uint8_t tagLen, uint8_t *pMac) const;
+    void m_Ctr(const uint8_t *pNonce, const uint8_t *pIn, uint8_t *pOut, uint16_t len) const;
+
+    uint8_t m_roundKeys[176];
+};
@@ -0,0 +1,193 @@
+//
+// MU_Aggregator.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Aggregator.h"
+#include <string.h>
+
+// --- Aggregate Frame Layout ---
+// [0] MU_PROTO_AGGREGATE
+// [1] Destination node ID
+// [2..] Sub-frames: [length][message], repeated until the end of the frame
+static constexpr uint8_t AGG_OFS_DST = 1;
+
+MU_Aggregator::MU_Aggregator()
+    : m_pModem(nullptr), m_nodeId(0), m_deadlineMs(MU_AGG_DEFAULT_DEADLINE_MS), m_buffers(), m_stats()
+{
+}
+
+MU_Modem_Error MU_Aggregator::begin(MU_Modem &modem, uint8_t nodeId)
+{
+    if (nodeId == MU_AGG_BROADCAST)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_nodeId = nodeId;
+    memset(m_buffers, 0, sizeof(m_buffers));
+    m_stats = MU_Aggregator_Stats();
+
+    return modem.AttachLayer(this);
+}
+
+MU_Modem_Error MU_Aggregator::Send(uint8_t dest, const uint8_t *pData, uint8_t len)
+{
+    if (!m_pModem)
+        return MU_Modem_Error::InvalidArg;
+    uint8_t frameLen = GetLayerFrameLen(*m_pModem);
+    if (!pData || len == 0 || len > frameLen - MU_AGG_HEADER_LEN - 1)
+        return MU_Modem_Error::InvalidArg;
+
+    int8_t index = m_FindOpen(dest);
+    if (index >= 0 && m_buffers[index].len + 1 + len > frameLen)
+    {
+        // Does not fit: send what is collected and start a new frame
+        if (m_FlushBuffer(m_buffers[index]) != MU_Modem_Error::Ok)
+            return MU_Modem_Error::Busy;
+        index = -1;
+    }
+
+    if (index < 0)
+    {
+        for (uint8_t i = 0; i < MU_AGG_BUFFERS; i++)
+        {
+            if (m_buffers[i].state == BufferState::Free)
+            {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0)
+            return MU_Modem_Error::Busy;
+
+        Buffer &buffer = m_buffers[index];
+        buffer.state = BufferState::Open;
+        buffer.messages = 0;
+        buffer.buf[0] = MU_PROTO_AGGREGATE;
+        buffer.buf[AGG_OFS_DST] = dest;
+        buffer.len = MU_AGG_HEADER_LEN;
+        buffer.firstAt = millis();
+    }
+
+    Buffer &buffer = m_buffers[index];
+    buffer.buf[buffer.len++] = len;
+    memcpy(&buffer.buf[buffer.len], pData, len);
+    buffer.len += len;
+    buffer.messages++;
+
+    // Flush on size as soon as not even a one-byte message fits any more
+    if (buffer.len + 2 > frameLen)
+        m_FlushBuffer(buffer);
+
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Aggregator::Flush(uint8_t dest)
+{
+    int8_t index = m_FindOpen(dest);
+    if (index < 0)
+        return MU_Modem_Error::Ok;
+    return m_FlushBuffer(m_buffers[index]);
+}
+
+MU_Modem_Error MU_Aggregator::FlushAll()
+{
+    MU_Modem_Error result = MU_Modem_Error::Ok;
+    for (uint8_t i = 0; i < MU_AGG_BUFFERS; i++)
+    {
+        if (m_buffers[i].state == BufferState::Open && m_FlushBuffer(m_buffers[i]) != MU_Modem_Error::Ok)
+            result = MU_Modem_Error::Busy;
+    }
+    return result;
+}
+
+int8_t MU_Aggregator::m_FindOpen(uint8_t dest) const
+{
+    for (uint8_t i = 0; i < MU_AGG_BUFFERS; i++)
+    {
+        if (m_buffers[i].state == BufferState::Open && m_buffers[i].buf[AGG_OFS_DST] == dest)
+            return i;
+    }
+    return -1;
+}
+
+MU_Modem_Error MU_Aggregator::m_FlushBuffer(Buffer &buffer)
+{
+    MU_Modem_Error err = m_pModem->TransmitDataAsync(buffer.buf, buffer.len);
+    if (err != MU_Modem_Error::Ok)
+        return err; // Stays open; Work() retries
+
+    buffer.state = BufferState::Queued;
+    m_stats.framesSent++;
+    m_stats.messagesSent += buffer.messages;
+    return MU_Modem_Error::Ok;
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Aggregator::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        for (uint8_t i = 0; i < MU_AGG_BUFFERS; i++)
+        {
+            Buffer &buffer = m_buffers[i];
+            if (buffer.state != BufferState::Queued || event.pPayload != buffer.buf)
+                continue;
+
+            buffer.state = BufferState::Free;
+            if (event.type == MU_Modem_Response::TxFailed)
+                m_stats.framesFailed++;
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived || event.payloadLen < MU_AGG_HEADER_LEN ||
+        event.pPayload[0] != MU_PROTO_AGGREGATE)
+        return false;
+
+    uint8_t dest = event.pPayload[AGG_OFS_DST];
+    if (dest != m_nodeId && dest != MU_AGG_BROADCAST)
+        return true;
+
+    // Unpack in place: each message is passed up as if it had arrived in its own frame
+    uint16_t pos = MU_AGG_HEADER_LEN;
+    while (pos < event.payloadLen)
+    {
+        uint8_t len = event.pPayload[pos++];
+        if (len == 0 || pos + len > event.payloadLen)
+            break; // Malformed tail
+
+        MU_Modem_Event sub = event;
+        sub.pPayload = event.pPayload + pos;
+        sub.payloadLen = len;
+        m_stats.messagesReceived++;
+        EmitEvent(modem, sub);
+        pos += len;
+    }
+    return true;
+}
+
+void MU_Aggregator::OnModemWork(MU_Modem &modem)
+{
+    (void)modem;
+    if (!m_pModem)
+        return;
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MU_AGG_BUFFERS; i++)
+    {
+        Buffer &buffer = m_buffers[i];
+        if (buffer.state == BufferState::Open && (uint32_t)(now - buffer.firstAt) >= m_deadlineMs &&
+            m_FlushBuffer(buffer) == MU_Modem_Error::Ok)
+        {
+            m_stats.deadlineFlushes++;
+        }
+    }
+}
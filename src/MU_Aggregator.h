@@ -0,0 +1,138 @@
+/**
+ * @file MU_Aggregator.h
+ * @brief Packs small application messages into shared MU frames.
+ *
+ * Every @DT carries fixed command, LBT and preamble overhead, so sending many
+ * 8-20 byte telemetry messages one per frame wastes airtime. The aggregator
+ * collects messages per destination into one frame of up to 255 bytes and
+ * flushes it when it is full or when the oldest message reaches its deadline.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Number of aggregation buffers (open or waiting for TxComplete), shared by all destinations.
+ */
+#ifndef MU_AGG_BUFFERS
+#define MU_AGG_BUFFERS 3
+#endif
+
+/**
+ * @brief Default time a message may wait for more messages before its frame is sent (ms).
+ */
+#ifndef MU_AGG_DEFAULT_DEADLINE_MS
+#define MU_AGG_DEFAULT_DEADLINE_MS 50
+#endif
+
+static constexpr uint8_t MU_AGG_HEADER_LEN = 2;                                              //!< Frame header bytes
+static constexpr uint8_t MU_AGG_MAX_MESSAGE_LEN = MU_LAYER_PAYLOAD_LEN - MU_AGG_HEADER_LEN - 1; //!< Largest single message
+static constexpr uint8_t MU_AGG_BROADCAST = 0xFF;                                            //!< Destination of every node
+
+/**
+ * @struct MU_Aggregator_Stats
+ * @brief Counters of the aggregation layer.
+ */
+struct MU_Aggregator_Stats
+{
+    uint32_t messagesSent;     //!< Messages passed to Send() and handed to the modem in a frame.
+    uint32_t framesSent;       //!< Aggregated frames handed to the modem.
+    uint32_t framesFailed;     //!< Aggregated frames reported as TxFailed.
+    uint32_t messagesReceived; //!< Messages unpacked from received frames.
+    uint32_t deadlineFlushes;  //!< Frames sent because the deadline expired rather than because they were full.
+};
+
+/**
+ * @class MU_Aggregator
+ * @brief Aggregating transmit layer for MU_Modem.
+ *
+ * Messages are addressed to one-byte node IDs carried in the frame header. On the
+ * receiver, frames for its node ID (or MU_AGG_BROADCAST) are unpacked and every message
+ * is passed up as its own DataReceived event, carrying the RSSI of the frame.
+ */
+class MU_Aggregator : public MU_Modem_Layer
+{
+public:
+    MU_Aggregator();
+
+    /**
+     * @brief Initializes the layer and attaches it to the driver.
+     * @param modem The driver to transmit through.
+     * @param nodeId Own node ID (0x00-0xFE).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if nodeId is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t nodeId);
+
+    /**
+     * @brief Sets how long the first message of a frame may wait for others.
+     * @param deadlineMs Deadline in ms. 0 sends every message at the next Work().
+     */
+    void SetFlushDeadline(uint32_t deadlineMs) { m_deadlineMs = deadlineMs; }
+
+    /**
+     * @brief Adds a message to the frame for a destination. The data is copied.
+     * @param dest Node ID of the destination, or MU_AGG_BROADCAST.
+     * @param pData Message to send.
+     * @param len Length of the message (1 to MU_AGG_MAX_MESSAGE_LEN, less the driver's framing
+     * overhead when encryption or the link tag is enabled; see MU_Modem::GetMaxPayloadLen()).
+     * @return MU_Modem_Error::Ok if accepted, MU_Modem_Error::Busy if no buffer is free,
+     * MU_Modem_Error::InvalidArg for bad arguments.
+     */
+    MU_Modem_Error Send(uint8_t dest, const uint8_t *pData, uint8_t len);
+
+    /**
+     * @brief Sends the pending frame for a destination without waiting for the deadline.
+     * @param dest Node ID of the destination.
+     * @return MU_Modem_Error::Ok if sent or nothing was pending, MU_Modem_Error::Busy if the modem queue is full.
+     */
+    MU_Modem_Error Flush(uint8_t dest);
+
+    /**
+     * @brief Sends every pending frame.
+     * @return MU_Modem_Error::Ok if all were sent, MU_Modem_Error::Busy otherwise.
+     */
+    MU_Modem_Error FlushAll();
+
+    /**
+     * @brief Returns the layer counters.
+     */
+    const MU_Aggregator_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the layer counters.
+     */
+    void ResetStats() { m_stats = MU_Aggregator_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    enum class BufferState : uint8_t
+    {
+        Free,
+        Open,  // Collecting messages
+        Queued // Handed to the modem, waiting for TxComplete/TxFailed
+    };
+
+    struct Buffer
+    {
+        BufferState state;
+        uint8_t messages;
+        uint8_t len;
+        uint32_t firstAt; // When the first message was added
+        uint8_t buf[MU_MAX_PAYLOAD_LEN];
+    };
+
+    int8_t m_FindOpen(uint8_t dest) const;
+    MU_Modem_Error m_FlushBuffer(Buffer &buffer);
+
+    MU_Modem *m_pModem;
+    uint8_t m_nodeId;
+    uint32_t m_deadlineMs;
+    Buffer m_buffers[MU_AGG_BUFFERS];
+    MU_Aggregator_Stats m_stats;
+};
@@ -0,0 +1,233 @@
+//
+// MU_Beacon.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Beacon.h"
+
+// --- Beacon Frame Layout ---
+// [0] MU_PROTO_BEACON
+// [1] Node ID of the sender
+// [2..3] Current beacon interval of the sender [s], big endian
+static constexpr uint8_t BEACON_OFS_ID = 1;
+static constexpr uint8_t BEACON_OFS_INTERVAL = 2;
+
+// Bytes on air: the beacon plus the driver's framing (codec header, link tag or encryption)
+static uint8_t beaconWireLen(const MU_Modem &modem)
+{
+    return (uint8_t)(MU_BEACON_FRAME_LEN + (MU_MAX_PAYLOAD_LEN - modem.GetMaxPayloadLen()));
+}
+
+static constexpr uint32_t BEACON_CHECK_PERIOD_MS = 1000;
+
+MU_Beacon::MU_Beacon()
+    : m_pModem(nullptr), m_pCallback(nullptr), m_config(), m_nodeId(0), m_running(false), m_pending(false), m_due(false),
+      m_changed(false), m_intervalMs(0), m_intervalStart(0), m_sendAt(0), m_lastCheck(0),
+      m_frame(), m_neighbors(), m_count(0), m_stats()
+{
+}
+
+MU_Modem_Error MU_Beacon::begin(MU_Modem &modem, uint8_t nodeId, MU_Beacon_Callback pCallback,
+                                const MU_Beacon_Config &config)
+{
+    if (config.minIntervalMs == 0 || config.minIntervalMs > config.maxIntervalMs || config.lostAfter < 3 ||
+        config.maxAirtimePermille > 1000)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_pCallback = pCallback;
+    m_config = config;
+    m_nodeId = nodeId;
+    modem.SetLinkTag(true, nodeId);
+
+    // One beacon per interval: keep the shortest interval above the airtime bound (tag included)
+    if (m_config.maxAirtimePermille)
+    {
+        uint32_t floorMs = modem.GetFrameAirtimeUs(beaconWireLen(modem)) / m_config.maxAirtimePermille;
+        if (m_config.minIntervalMs < floorMs)
+            m_config.minIntervalMs = floorMs;
+        if (m_config.maxIntervalMs < m_config.minIntervalMs)
+            m_config.maxIntervalMs = m_config.minIntervalMs;
+    }
+
+    m_pending = false;
+    m_count = 0;
+    m_lastCheck = millis();
+    m_stats = MU_Beacon_Stats();
+    m_frame[0] = MU_PROTO_BEACON;
+    m_frame[BEACON_OFS_ID] = nodeId;
+
+    Restart();
+    return modem.AttachLayer(this);
+}
+
+void MU_Beacon::Restart()
+{
+    m_running = true;
+    m_intervalMs = 0; // Forces the minimum
+    m_ResetInterval();
+}
+
+void MU_Beacon::m_ResetInterval()
+{
+    // Only an interval longer than the minimum is cut short; otherwise a burst of changes would postpone the beacon forever
+    if (m_intervalMs == m_config.minIntervalMs)
+    {
+        m_changed = true;
+        return;
+    }
+    m_intervalMs = m_config.minIntervalMs;
+    m_intervalStart = millis();
+    m_ScheduleNext();
+}
+
+void MU_Beacon::m_ScheduleNext()
+{
+    // Send at a random point of the second half of the interval, so neighbors that reset together do not collide
+    uint32_t half = m_intervalMs / 2;
+    m_sendAt = m_intervalStart + half + (uint32_t)random((long)(m_intervalMs - half));
+    m_due = true;
+    m_changed = false;
+}
+
+void MU_Beacon::m_CheckLost(uint32_t now)
+{
+    uint8_t i = 0;
+    while (i < m_count)
+    {
+        // Any frame of the neighbor keeps it alive: the driver's table has the time of the last one
+        const MU_Modem_Neighbor *pInfo = m_pModem->GetNeighbor(m_neighbors[i].id);
+        uint32_t limitMs = (uint32_t)m_neighbors[i].intervalS * 1000 * m_config.lostAfter;
+        if (pInfo && (uint32_t)(now - pInfo->lastSeenMs) <= limitMs)
+        {
+            i++;
+            continue;
+        }
+
+        MU_Beacon_Event ev;
+        ev.type = MU_Beacon_EventType::Lost;
+        ev.id = m_neighbors[i].id;
+        ev.rssiDbm = pInfo ? pInfo->rssiDbm : 0;
+        m_neighbors[i] = m_neighbors[--m_count];
+        m_stats.lost++;
+        m_ResetInterval();
+        if (m_pCallback)
+            m_pCallback(ev);
+    }
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Beacon::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    (void)modem;
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        if (m_pending && event.pPayload == m_frame)
+        {
+            m_pending = false;
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived || event.payloadLen < MU_BEACON_FRAME_LEN ||
+        event.pPayload[0] != MU_PROTO_BEACON)
+        return false;
+
+    m_stats.received++;
+    uint8_t id = event.pPayload[BEACON_OFS_ID];
+    uint16_t intervalS = (uint16_t)((event.pPayload[BEACON_OFS_INTERVAL] << 8) | event.pPayload[BEACON_OFS_INTERVAL + 1]);
+    if (id == m_nodeId)
+        return true;
+
+    for (uint8_t i = 0; i < m_count; i++)
+    {
+        if (m_neighbors[i].id == id)
+        {
+            m_neighbors[i].intervalS = intervalS;
+            return true;
+        }
+    }
+
+    if (m_count >= MU_BEACON_MAX_NEIGHBORS)
+        return true;
+
+    m_neighbors[m_count].id = id;
+    m_neighbors[m_count].intervalS = intervalS;
+    m_count++;
+    m_stats.found++;
+    m_ResetInterval();
+
+    if (m_pCallback)
+    {
+        MU_Beacon_Event ev;
+        ev.type = MU_Beacon_EventType::Found;
+        ev.id = id;
+        ev.rssiDbm = (int16_t)event.value;
+        m_pCallback(ev);
+    }
+    return true;
+}
+
+void MU_Beacon::OnModemWork(MU_Modem &modem)
+{
+    if (!m_pModem)
+        return;
+
+    uint32_t now = millis();
+    if ((uint32_t)(now - m_lastCheck) >= BEACON_CHECK_PERIOD_MS)
+    {
+        m_lastCheck = now;
+        m_CheckLost(now);
+    }
+
+    if (!m_running)
+        return;
+
+    if (m_due && (int32_t)(now - m_sendAt) >= 0)
+    {
+        // Sent even if other frames went out: only beacons tell new neighbors about us and carry our interval
+        if (m_pending)
+        {
+            m_stats.suppressed++;
+        }
+        else
+        {
+            uint32_t intervalS = (m_intervalMs + 999) / 1000;
+            if (intervalS > 0xFFFF)
+                intervalS = 0xFFFF;
+            m_frame[BEACON_OFS_INTERVAL] = (uint8_t)(intervalS >> 8);
+            m_frame[BEACON_OFS_INTERVAL + 1] = (uint8_t)intervalS;
+            if (modem.TransmitDataAsync(m_frame, MU_BEACON_FRAME_LEN) == MU_Modem_Error::Ok)
+            {
+                m_pending = true;
+                m_stats.sent++;
+                m_stats.airtimeMs += modem.GetFrameAirtimeUs(beaconWireLen(modem)) / 1000;
+            }
+            else
+            {
+                m_stats.suppressed++; // Queue full: the channel is busy with our own traffic anyway
+            }
+        }
+        m_due = false;
+    }
+
+    if ((uint32_t)(now - m_intervalStart) >= m_intervalMs)
+    {
+        // A quiet interval doubles the next one
+        if (!m_changed)
+        {
+            m_intervalMs *= 2;
+            if (m_intervalMs > m_config.maxIntervalMs)
+                m_intervalMs = m_config.maxIntervalMs;
+        }
+        m_intervalStart = now;
+        m_ScheduleNext();
+    }
+}
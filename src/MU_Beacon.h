@@ -0,0 +1,168 @@
+/**
+ * @file MU_Beacon.h
+ * @brief Neighbor discovery with periodic, adaptive beacons.
+ *
+ * Every node broadcasts a 4-byte beacon at a jittered interval that doubles
+ * while the neighborhood stays unchanged and drops back to the minimum when a
+ * neighbor appears or disappears. Beacons are sent with the driver's link tag,
+ * so the driver's neighbor table (RSSI, loss, age) is filled without any
+ * provisioning. Neighbors are found from beacons only, and are kept alive by
+ * any of their frames.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Neighbors whose beacon interval is tracked for loss detection.
+ */
+#ifndef MU_BEACON_MAX_NEIGHBORS
+#define MU_BEACON_MAX_NEIGHBORS MU_NEIGHBOR_TABLE_SIZE
+#endif
+
+static constexpr uint8_t MU_BEACON_FRAME_LEN = 4; //!< Beacon payload bytes (before the link tag)
+
+/**
+ * @struct MU_Beacon_Config
+ * @brief Timing of the beacons.
+ */
+struct MU_Beacon_Config
+{
+    uint32_t minIntervalMs = 2000;   //!< Interval after a change of the neighborhood [ms].
+    uint32_t maxIntervalMs = 120000; //!< Interval of a stable neighborhood [ms].
+    uint16_t maxAirtimePermille = 5; //!< Upper bound of the airtime spent on beacons [1/1000]. Raises minIntervalMs if needed.
+    uint8_t lostAfter = 3;           //!< Announced intervals of silence before a neighbor is lost (at least 3: intervals double).
+};
+
+/**
+ * @enum MU_Beacon_EventType
+ * @brief Changes of the neighborhood.
+ */
+enum class MU_Beacon_EventType : uint8_t
+{
+    Found, //!< First beacon of a node.
+    Lost   //!< Nothing heard from the node for lostAfter of its intervals.
+};
+
+/**
+ * @struct MU_Beacon_Event
+ * @brief A change of the neighborhood.
+ */
+struct MU_Beacon_Event
+{
+    MU_Beacon_EventType type; //!< Found or lost.
+    uint8_t id;               //!< Node ID of the neighbor.
+    int16_t rssiDbm;          //!< RSSI of the last beacon (Found) or the smoothed RSSI (Lost) [dBm].
+};
+
+/**
+ * @typedef MU_Beacon_Callback
+ * @brief Callback function type for neighborhood changes.
+ */
+typedef void (*MU_Beacon_Callback)(const MU_Beacon_Event &event);
+
+/**
+ * @struct MU_Beacon_Stats
+ * @brief Counters of the beacon protocol.
+ */
+struct MU_Beacon_Stats
+{
+    uint32_t sent;       //!< Beacons handed to the modem.
+    uint32_t suppressed; //!< Beacons skipped because the previous one was still queued or the queue was full.
+    uint32_t received;   //!< Beacons received.
+    uint32_t found;      //!< Neighbors discovered.
+    uint32_t lost;       //!< Neighbors lost.
+    uint32_t airtimeMs;  //!< Estimated airtime of the beacons sent [ms].
+};
+
+/**
+ * @class MU_Beacon
+ * @brief Neighbor discovery layer for MU_Modem.
+ *
+ * begin() enables the driver's link tag with the given node ID (2 bytes on every frame), as
+ * the neighbor table is keyed on it. Neighbor RSSI, loss and age are read from the driver
+ * with GetNeighbor()/GetNeighborAt(). All nodes should use the same configuration.
+ */
+class MU_Beacon : public MU_Modem_Layer
+{
+public:
+    MU_Beacon();
+
+    /**
+     * @brief Initializes the beacons and attaches the layer to the driver. The first beacon is sent
+     * within minIntervalMs.
+     * @param modem The driver.
+     * @param nodeId Own node ID, used as the link tag.
+     * @param pCallback Optional callback for found and lost neighbors.
+     * @param config Beacon timing.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the configuration is invalid
+     * (e.g. lostAfter below 3).
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t nodeId, MU_Beacon_Callback pCallback = nullptr,
+                         const MU_Beacon_Config &config = MU_Beacon_Config());
+
+    /**
+     * @brief Stops sending beacons. Received beacons are still processed.
+     */
+    void Stop() { m_running = false; }
+
+    /**
+     * @brief Resumes beacons at the minimum interval (e.g. after moving the node).
+     */
+    void Restart();
+
+    /**
+     * @brief Returns the current beacon interval [ms].
+     */
+    uint32_t GetIntervalMs() const { return m_intervalMs; }
+
+    /**
+     * @brief Returns the number of neighbors currently considered present.
+     */
+    uint8_t GetNeighborCount() const { return m_count; }
+
+    /**
+     * @brief Returns the beacon counters.
+     */
+    const MU_Beacon_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the beacon counters.
+     */
+    void ResetStats() { m_stats = MU_Beacon_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    struct Neighbor
+    {
+        uint8_t id;
+        uint16_t intervalS; // Interval announced in the neighbor's last beacon [s]
+    };
+
+    void m_ResetInterval();
+    void m_ScheduleNext();
+    void m_CheckLost(uint32_t now);
+
+    MU_Modem *m_pModem;
+    MU_Beacon_Callback m_pCallback;
+    MU_Beacon_Config m_config;
+    uint8_t m_nodeId;
+    bool m_running;
+    bool m_pending;      // m_frame is queued in the modem
+    bool m_due;          // The beacon of the current interval is still to be sent
+    bool m_changed;      // The neighborhood changed during the current interval
+    uint32_t m_intervalMs;
+    uint32_t m_intervalStart;
+    uint32_t m_sendAt;   // Jittered beacon time inside the current interval
+    uint32_t m_lastCheck;
+    uint8_t m_frame[MU_BEACON_FRAME_LEN];
+    Neighbor m_neighbors[MU_BEACON_MAX_NEIGHBORS];
+    uint8_t m_count;
+    MU_Beacon_Stats m_stats;
+};
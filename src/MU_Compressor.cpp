@@ -0,0 +1,135 @@
+//
+// MU_Compressor.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Compressor.h"
+
+// --- Token Format ---
+// A flag byte precedes each group of up to eight tokens, bit 0 first.
+// Flag 0: literal byte.
+// Flag 1: match, two bytes: [distance[11:8] << 4 | (length - 3)] [distance[7:0]]
+//         copying `length` bytes starting `distance` bytes back (dictionary included).
+
+uint16_t MU_Compressor::Compress(const uint8_t *pIn, uint16_t len, uint8_t *pOut, uint16_t outMax,
+                                 const uint8_t *pDict, uint16_t dictLen)
+{
+    if (!pDict)
+        dictLen = 0;
+    if (dictLen > MU_COMPRESS_MAX_DISTANCE)
+    {
+        pDict += dictLen - MU_COMPRESS_MAX_DISTANCE;
+        dictLen = MU_COMPRESS_MAX_DISTANCE;
+    }
+
+    uint16_t outPos = 0;
+    uint16_t flagPos = 0;
+    uint8_t flagBit = 8; // Forces a new flag byte for the first token
+    uint16_t pos = 0;
+
+    while (pos < len)
+    {
+        if (flagBit == 8)
+        {
+            if (outPos >= outMax)
+                return 0;
+            flagPos = outPos++;
+            pOut[flagPos] = 0;
+            flagBit = 0;
+        }
+
+        // Longest match in the window: the dictionary followed by the data already encoded
+        uint16_t bestLen = 0;
+        uint16_t bestDist = 0;
+        uint16_t maxLen = (len - pos < MU_COMPRESS_MAX_MATCH) ? (len - pos) : MU_COMPRESS_MAX_MATCH;
+        uint32_t here = (uint32_t)dictLen + pos;
+        uint32_t windowStart = (here > MU_COMPRESS_MAX_DISTANCE) ? here - MU_COMPRESS_MAX_DISTANCE : 0;
+        if (maxLen >= MU_COMPRESS_MIN_MATCH)
+        {
+            for (uint32_t start = windowStart; start < here; start++)
+            {
+                uint16_t l = 0;
+                while (l < maxLen)
+                {
+                    uint32_t at = start + l;
+                    uint8_t c = (at < dictLen) ? pDict[at] : pIn[at - dictLen];
+                    if (c != pIn[pos + l])
+                        break;
+                    l++;
+                }
+                if (l > bestLen)
+                {
+                    bestLen = l;
+                    bestDist = (uint16_t)(here - start);
+                    if (l == maxLen)
+                        break;
+                }
+            }
+        }
+
+        if (bestLen >= MU_COMPRESS_MIN_MATCH)
+        {
+            if (outPos + 2 > outMax)
+                return 0;
+            pOut[flagPos] |= (uint8_t)(1 << flagBit);
+            pOut[outPos++] = (uint8_t)(((bestDist >> 8) << 4) | (bestLen - MU_COMPRESS_MIN_MATCH));
+            pOut[outPos++] = (uint8_t)(bestDist & 0xFF);
+            pos += bestLen;
+        }
+        else
+        {
+            if (outPos >= outMax)
+                return 0;
+            pOut[outPos++] = pIn[pos++];
+        }
+        flagBit++;
+    }
+    return outPos;
+}
+
+int32_t MU_Compressor::Decompress(const uint8_t *pIn, uint16_t len, uint8_t *pOut, uint16_t outMax,
+                                  const uint8_t *pDict, uint16_t dictLen)
+{
+    if (!pDict)
+        dictLen = 0;
+    if (dictLen > MU_COMPRESS_MAX_DISTANCE)
+    {
+        pDict += dictLen - MU_COMPRESS_MAX_DISTANCE;
+        dictLen = MU_COMPRESS_MAX_DISTANCE;
+    }
+
+    uint16_t inPos = 0;
+    uint16_t outPos = 0;
+    while (inPos < len)
+    {
+        uint8_t flags = pIn[inPos++];
+        for (uint8_t bit = 0; bit < 8 && inPos < len; bit++)
+        {
+            if (!(flags & (1 << bit)))
+            {
+                if (outPos >= outMax)
+                    return -1;
+                pOut[outPos++] = pIn[inPos++];
+                continue;
+            }
+
+            if (inPos + 2 > len)
+                return -1;
+            uint16_t matchLen = (pIn[inPos] & 0x0F) + MU_COMPRESS_MIN_MATCH;
+            uint16_t dist = (uint16_t)(((pIn[inPos] >> 4) << 8) | pIn[inPos + 1]);
+            inPos += 2;
+
+            uint32_t here = (uint32_t)dictLen + outPos;
+            if (dist == 0 || dist > here || outPos + matchLen > outMax)
+                return -1;
+
+            // Byte by byte: a match may overlap the bytes it produces
+            uint32_t from = here - dist;
+            for (uint16_t i = 0; i < matchLen; i++, from++)
+                pOut[outPos++] = (from < dictLen) ? pDict[from] : pOut[from - dictLen];
+        }
+    }
+    return outPos;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file MU_Compressor.h
+ * @brief Small-window LZ compression for MU frame payloads.
+ *
+ * LZSS variant sized for one frame: 12-bit distances, 3-18 byte matches and
+ * one flag byte per eight items. An optional static dictionary acts as data
+ * preceding every payload, which pays off on short, repetitive telemetry.
+ * Needs no RAM beyond the output buffer.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include <Arduino.h>
+
+static constexpr uint16_t MU_COMPRESS_MAX_DISTANCE = 4095; //!< Farthest match back (dictionary included)
+static constexpr uint8_t MU_COMPRESS_MIN_MATCH = 3;        //!< Shortest match worth encoding
+static constexpr uint8_t MU_COMPRESS_MAX_MATCH = 18;       //!< Longest match of one token
+
+/**
+ * @class MU_Compressor
+ * @brief Stateless LZSS encoder/decoder.
+ */
+class MU_Compressor
+{
+public:
+    /**
+     * @brief Compresses a payload.
+     * @param pIn Data to compress.
+     * @param len Length of the data.
+     * @param pOut Output buffer.
+     * @param outMax Size of the output buffer. Compression fails if the result does not fit.
+     * @param pDict Optional static dictionary (may be nullptr).
+     * @param dictLen Length of the dictionary. Only the last MU_COMPRESS_MAX_DISTANCE bytes are used.
+     * @return Compressed length, or 0 if the result would not fit in outMax.
+     */
+    static uint16_t Compress(const uint8_t *pIn, uint16_t len, uint8_t *pOut, uint16_t outMax,
+                             const uint8_t *pDict = nullptr, uint16_t dictLen = 0);
+
+    /**
+     * @brief Decompresses a payload produced by Compress().
+     * @param pIn Compressed data.
+     * @param len Length of the compressed data.
+     * @param pOut Output buffer.
+     * @param outMax Size of the output buffer.
+     * @param pDict The dictionary used for compression (may be nullptr).
+     * @param dictLen Length of the dictionary.
+     * @return Decompressed length, or -1 if the data is corrupt or does not fit.
+     */
+    static int32_t Decompress(const uint8_t *pIn, uint16_t len, uint8_t *pOut, uint16_t outMax,
+                              const uint8_t *pDict = nullptr, uint16_t dictLen = 0);
+};
@@ -0,0 +1,669 @@
+//
+// MU_Fragmenter.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Fragmenter.h"
+#include <string.h>
+
+// --- Fragment Frame Layout ---
+// [0] MU_PROTO_FRAGMENT
+// [1] Source node ID
+// [2] Message ID
+// [3] Fragment index
+// [4] Index of the last fragment
+// [5..] Data: the sender's chunk length (at most MU_FRAG_CHUNK_LEN), fewer in the last fragment only
+static constexpr uint8_t FRAG_OFS_SRC = 1;
+static constexpr uint8_t FRAG_OFS_MSG_ID = 2;
+static constexpr uint8_t FRAG_OFS_INDEX = 3;
+static constexpr uint8_t FRAG_OFS_LAST_INDEX = 4;
+
+// --- FEC Frame Layout ---
+// [0] MU_PROTO_FEC
+// [1] Source node ID
+// [2] Message ID
+// [3] Index of the last data fragment
+// [4] Data length of the last data fragment
+// [5] Data fragments per block (high nibble), repair frames per block (low nibble)
+// [6] Block number
+// [7] Symbol in block: 0..k-1 data fragment (block * k + j), k..k+m-1 repair frame
+// [8..] Data: the sender's chunk length (at most MU_FEC_CHUNK_LEN), fewer in the last data fragment only
+static constexpr uint8_t FEC_OFS_LAST_INDEX = 3;
+static constexpr uint8_t FEC_OFS_LAST_LEN = 4;
+static constexpr uint8_t FEC_OFS_PARAMS = 5;
+static constexpr uint8_t FEC_OFS_BLOCK = 6;
+static constexpr uint8_t FEC_OFS_SYMBOL = 7;
+
+// --- GF(2^8) Arithmetic (polynomial 0x11D) ---
+// Shift-and-add instead of log tables: no RAM cost, and air time dominates anyway.
+
+static uint8_t gfMul(uint8_t a, uint8_t b)
+{
+    uint8_t p = 0;
+    while (b)
+    {
+        if (b & 1)
+            p ^= a;
+        a = (a & 0x80) ? (uint8_t)((a << 1) ^ 0x1D) : (uint8_t)(a << 1);
+        b >>= 1;
+    }
+    return p;
+}
+
+static uint8_t gfInv(uint8_t a)
+{
+    // a^254 == a^-1 in GF(2^8)
+    uint8_t result = 1;
+    uint8_t base = a;
+    for (uint8_t e = 254; e; e >>= 1)
+    {
+        if (e & 1)
+            result = gfMul(result, base);
+        base = gfMul(base, base);
+    }
+    return result;
+}
+
+static uint8_t fecCoef(uint8_t k, uint8_t r, uint8_t j)
+{
+    // Cauchy matrix 1 / (x_r + y_j) with x_r = k + r and y_j = j: every square submatrix is invertible,
+    // so any k of the k + m symbols of a block rebuild the data
+    return gfInv((uint8_t)((k + r) ^ j));
+}
+
+static void gfMulAdd(uint8_t *pDst, const uint8_t *pSrc, uint8_t coef, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+        pDst[i] ^= gfMul(coef, pSrc[i]);
+}
+
+MU_Fragmenter::MU_Fragmenter()
+    : m_pModem(nullptr), m_pCallback(nullptr), m_nodeId(0), m_pTxData(nullptr), m_txLen(0), m_txMessageId(0),
+      m_txLastIndex(0), m_txChunkLen(0), m_txNextIndex(0), m_txSymbolCount(0), m_txFailed(false), m_fecData(0), m_fecRepair(0),
+      m_txFrames(), m_rx(), m_arenaUsed(0), m_stats()
+{
+}
+
+MU_Modem_Error MU_Fragmenter::begin(MU_Modem &modem, uint8_t nodeId, MU_Fragmenter_Callback pCallback)
+{
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_pCallback = pCallback;
+    m_nodeId = nodeId;
+    m_pTxData = nullptr;
+    m_txMessageId = (uint8_t)random(256);
+    memset(m_txFrames, 0, sizeof(m_txFrames));
+    memset(m_rx, 0, sizeof(m_rx));
+    m_arenaUsed = 0;
+    m_stats = MU_Fragmenter_Stats();
+
+    return modem.AttachLayer(this);
+}
+
+MU_Modem_Error MU_Fragmenter::SetFec(uint8_t dataPerBlock, uint8_t repairPerBlock)
+{
+    if (m_pTxData)
+        return MU_Modem_Error::Busy;
+    if (repairPerBlock == 0)
+    {
+        m_fecData = 0;
+        m_fecRepair = 0;
+        return MU_Modem_Error::Ok;
+    }
+    if (dataPerBlock == 0 || dataPerBlock > MU_FEC_MAX_BLOCK || repairPerBlock > dataPerBlock)
+        return MU_Modem_Error::InvalidArg;
+
+    m_fecData = dataPerBlock;
+    m_fecRepair = repairPerBlock;
+    return MU_Modem_Error::Ok;
+}
+
+// --- Sending ---
+
+MU_Modem_Error MU_Fragmenter::Send(const uint8_t *pData, uint32_t len, uint8_t *pMessageId)
+{
+    if (!m_pModem)
+        return MU_Modem_Error::InvalidArg;
+    bool fec = m_fecRepair != 0;
+    uint8_t chunkLen = (uint8_t)(GetLayerFrameLen(*m_pModem) - (fec ? MU_FEC_HEADER_LEN : MU_FRAG_HEADER_LEN));
+    if (!pData || len == 0 || len > 256UL * chunkLen)
+        return MU_Modem_Error::InvalidArg;
+    if (m_pTxData)
+        return MU_Modem_Error::Busy;
+
+    uint16_t fragments = (uint16_t)((len - 1) / chunkLen + 1);
+    uint16_t symbols = fragments;
+    if (fec)
+    {
+        // Repair frames are numbered block * m + r in the receiver's bitmap
+        uint16_t blocks = (fragments + m_fecData - 1) / m_fecData;
+        if (blocks * m_fecRepair > 256)
+            return MU_Modem_Error::InvalidArg;
+        symbols = blocks * (m_fecData + m_fecRepair);
+    }
+
+    m_pTxData = pData;
+    m_txLen = len;
+    m_txMessageId++;
+    m_txLastIndex = (uint8_t)(fragments - 1);
+    m_txChunkLen = chunkLen;
+    m_txNextIndex = 0;
+    m_txSymbolCount = symbols;
+    m_txFailed = false;
+    if (pMessageId)
+        *pMessageId = m_txMessageId;
+
+    m_PumpTx();
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Fragmenter::m_PumpTx()
+{
+    // Keep every pipeline slot filled so the modem transmits back to back
+    while (m_pTxData && !m_txFailed && m_txNextIndex < m_txSymbolCount)
+    {
+        TxFrame *pFrame = nullptr;
+        for (uint8_t i = 0; i < MU_TX_PIPELINE_DEPTH; i++)
+        {
+            if (!m_txFrames[i].queued)
+            {
+                pFrame = &m_txFrames[i];
+                break;
+            }
+        }
+        if (!pFrame)
+            return;
+
+        uint8_t frameLen;
+        if (m_fecRepair)
+        {
+            frameLen = m_BuildFecFrame(pFrame->buf, m_txNextIndex);
+            if (frameLen == 0)
+            {
+                m_txNextIndex++; // Padding position of the last block: never sent
+                continue;
+            }
+        }
+        else
+        {
+            uint32_t offset = (uint32_t)m_txNextIndex * m_txChunkLen;
+            uint32_t chunk = m_txLen - offset;
+            if (chunk > m_txChunkLen)
+                chunk = m_txChunkLen;
+
+            pFrame->buf[0] = MU_PROTO_FRAGMENT;
+            pFrame->buf[FRAG_OFS_SRC] = m_nodeId;
+            pFrame->buf[FRAG_OFS_MSG_ID] = m_txMessageId;
+            pFrame->buf[FRAG_OFS_INDEX] = (uint8_t)m_txNextIndex;
+            pFrame->buf[FRAG_OFS_LAST_INDEX] = m_txLastIndex;
+            memcpy(&pFrame->buf[MU_FRAG_HEADER_LEN], m_pTxData + offset, chunk);
+            frameLen = (uint8_t)(MU_FRAG_HEADER_LEN + chunk);
+        }
+
+        if (m_pModem->TransmitDataAsync(pFrame->buf, frameLen) != MU_Modem_Error::Ok)
+            return; // Queue full; retried from Work()
+
+        pFrame->queued = true;
+        m_txNextIndex++;
+        m_stats.fragmentsSent++;
+    }
+}
+
+uint8_t MU_Fragmenter::m_BuildFecFrame(uint8_t *pFrame, uint16_t symbol)
+{
+    uint8_t k = m_fecData;
+    uint8_t block = (uint8_t)(symbol / (k + m_fecRepair));
+    uint8_t j = (uint8_t)(symbol % (k + m_fecRepair));
+    uint16_t firstIndex = (uint16_t)block * k;
+    uint8_t chunkLen = m_txChunkLen;
+    uint32_t lastLen = m_txLen - (uint32_t)m_txLastIndex * chunkLen;
+
+    pFrame[0] = MU_PROTO_FEC;
+    pFrame[FRAG_OFS_SRC] = m_nodeId;
+    pFrame[FRAG_OFS_MSG_ID] = m_txMessageId;
+    pFrame[FEC_OFS_LAST_INDEX] = m_txLastIndex;
+    pFrame[FEC_OFS_LAST_LEN] = (uint8_t)lastLen;
+    pFrame[FEC_OFS_PARAMS] = (uint8_t)((k << 4) | m_fecRepair);
+    pFrame[FEC_OFS_BLOCK] = block;
+    pFrame[FEC_OFS_SYMBOL] = j;
+    uint8_t *pData = pFrame + MU_FEC_HEADER_LEN;
+
+    if (j < k)
+    {
+        // Systematic part: the data fragment itself
+        uint16_t index = firstIndex + j;
+        if (index > m_txLastIndex)
+            return 0;
+        uint8_t len = (index == m_txLastIndex) ? (uint8_t)lastLen : chunkLen;
+        memcpy(pData, m_pTxData + (uint32_t)index * chunkLen, len);
+        return MU_FEC_HEADER_LEN + len;
+    }
+
+    // Repair frame: linear combination of the block's fragments, the short last one zero padded
+    memset(pData, 0, chunkLen);
+    for (uint8_t d = 0; d < k && firstIndex + d <= m_txLastIndex; d++)
+    {
+        uint16_t index = firstIndex + d;
+        uint8_t len = (index == m_txLastIndex) ? (uint8_t)lastLen : chunkLen;
+        gfMulAdd(pData, m_pTxData + (uint32_t)index * chunkLen, fecCoef(k, j - k, d), len);
+    }
+    m_stats.repairsSent++;
+    return MU_FEC_HEADER_LEN + chunkLen;
+}
+
+void MU_Fragmenter::m_FinishTx(MU_Fragmenter_EventType type)
+{
+    uint32_t len = m_txLen;
+    m_pTxData = nullptr;
+    if (type == MU_Fragmenter_EventType::SendComplete)
+        m_stats.messagesSent++;
+    m_Notify(type, m_nodeId, m_txMessageId, nullptr, len);
+}
+
+// --- Receiving ---
+
+void MU_Fragmenter::m_OnFragment(const uint8_t *pFrame, uint8_t len)
+{
+    uint8_t source = pFrame[FRAG_OFS_SRC];
+    uint8_t messageId = pFrame[FRAG_OFS_MSG_ID];
+    uint8_t index = pFrame[FRAG_OFS_INDEX];
+    uint8_t lastIndex = pFrame[FRAG_OFS_LAST_INDEX];
+    const uint8_t *pData = pFrame + MU_FRAG_HEADER_LEN;
+    uint8_t dataLen = len - MU_FRAG_HEADER_LEN;
+
+    if (index > lastIndex || dataLen > MU_FRAG_CHUNK_LEN)
+        return;
+
+    if (lastIndex == 0)
+    {
+        // Single-fragment message: deliver straight from the receive buffer
+        m_stats.fragmentsReceived++;
+        m_stats.messagesReceived++;
+        m_Notify(MU_Fragmenter_EventType::Received, source, messageId, pData, dataLen);
+        return;
+    }
+
+    int8_t ctxIndex = m_FindContext(source, messageId, lastIndex, false);
+    if (ctxIndex < 0)
+    {
+        ctxIndex = m_AllocContext(source, messageId, lastIndex, MU_FRAG_CHUNK_LEN, 0);
+        if (ctxIndex < 0)
+        {
+            m_stats.rxOverflows++;
+            return;
+        }
+    }
+
+    RxContext &ctx = m_rx[ctxIndex];
+    if (index == lastIndex)
+        ctx.lastLen = dataLen;
+    else if (!m_CheckChunkLen(ctx, dataLen))
+        return;
+    m_StoreFragment(ctxIndex, index, pData, dataLen);
+    m_CompleteIfDone(ctxIndex);
+}
+
+void MU_Fragmenter::m_OnFecFrame(const uint8_t *pFrame, uint8_t len)
+{
+    uint8_t source = pFrame[FRAG_OFS_SRC];
+    uint8_t messageId = pFrame[FRAG_OFS_MSG_ID];
+    uint8_t lastIndex = pFrame[FEC_OFS_LAST_INDEX];
+    uint8_t lastLen = pFrame[FEC_OFS_LAST_LEN];
+    uint8_t k = pFrame[FEC_OFS_PARAMS] >> 4;
+    uint8_t m = pFrame[FEC_OFS_PARAMS] & 0x0F;
+    uint8_t block = pFrame[FEC_OFS_BLOCK];
+    uint8_t j = pFrame[FEC_OFS_SYMBOL];
+    const uint8_t *pData = pFrame + MU_FEC_HEADER_LEN;
+    uint8_t dataLen = len - MU_FEC_HEADER_LEN;
+
+    uint16_t blocks = ((uint16_t)lastIndex + k) / (k ? k : 1);
+    if (k == 0 || m == 0 || m > k || j >= k + m || block >= blocks || blocks * m > 256 ||
+        lastLen == 0 || lastLen > MU_FEC_CHUNK_LEN)
+        return;
+
+    uint16_t index = (uint16_t)block * k + j;
+    if (dataLen > MU_FEC_CHUNK_LEN || (j < k && (index > lastIndex || (index == lastIndex && dataLen != lastLen))))
+        return;
+
+    int8_t ctxIndex = m_FindContext(source, messageId, lastIndex, true);
+    if (ctxIndex < 0)
+    {
+        ctxIndex = m_AllocContext(source, messageId, lastIndex, MU_FEC_CHUNK_LEN, blocks * m);
+        if (ctxIndex < 0)
+        {
+            m_stats.rxOverflows++;
+            return;
+        }
+        RxContext &ctx = m_rx[ctxIndex];
+        ctx.fec = true;
+        ctx.fecData = k;
+        ctx.fecRepair = m;
+        ctx.lastLen = lastLen;
+    }
+
+    RxContext &ctx = m_rx[ctxIndex];
+    if (ctx.fecData != k || ctx.fecRepair != m)
+        return;
+    if ((j >= k || index < lastIndex) && !m_CheckChunkLen(ctx, dataLen))
+        return;
+
+    if (j < k)
+    {
+        m_StoreFragment(ctxIndex, (uint8_t)index, pData, dataLen);
+    }
+    else
+    {
+        uint16_t repair = (uint16_t)block * m + (j - k);
+        uint8_t mask = (uint8_t)(1 << (repair & 7));
+        if (ctx.repairMap[repair >> 3] & mask)
+            return; // Duplicate
+        ctx.repairMap[repair >> 3] |= mask;
+        ctx.lastRxAt = millis();
+        uint8_t *pDst = &m_arena[ctx.offset + ((uint16_t)lastIndex + 1 + repair) * ctx.stride];
+        memcpy(pDst, pData, dataLen);
+        memset(pDst + dataLen, 0, ctx.stride - dataLen);
+        m_stats.fragmentsReceived++;
+    }
+
+    m_TryRecoverBlock(ctx, block);
+    m_CompleteIfDone(ctxIndex);
+}
+
+void MU_Fragmenter::m_StoreFragment(uint8_t ctxIndex, uint8_t index, const uint8_t *pData, uint8_t len)
+{
+    RxContext &ctx = m_rx[ctxIndex];
+    uint8_t mask = (uint8_t)(1 << (index & 7));
+    if (ctx.bitmap[index >> 3] & mask)
+        return; // Duplicate
+
+    ctx.bitmap[index >> 3] |= mask;
+    ctx.received++;
+    ctx.lastRxAt = millis();
+    uint8_t *pDst = &m_arena[ctx.offset + (uint16_t)index * ctx.stride];
+    memcpy(pDst, pData, len);
+    if (len < ctx.stride)
+        memset(pDst + len, 0, ctx.stride - len); // Zero padding for the erasure code
+    m_stats.fragmentsReceived++;
+}
+
+void MU_Fragmenter::m_TryRecoverBlock(RxContext &ctx, uint8_t block)
+{
+    uint8_t k = ctx.fecData;
+    uint8_t m = ctx.fecRepair;
+    uint16_t firstIndex = (uint16_t)block * k;
+    uint8_t count = ((uint16_t)ctx.lastIndex + 1 - firstIndex < k) ? (uint8_t)(ctx.lastIndex + 1 - firstIndex) : k;
+
+    uint8_t missing[MU_FEC_MAX_BLOCK];
+    uint8_t repairs[MU_FEC_MAX_BLOCK];
+    uint8_t numMissing = 0;
+    uint8_t numRepairs = 0;
+    for (uint8_t d = 0; d < count; d++)
+    {
+        uint16_t index = firstIndex + d;
+        if (!(ctx.bitmap[index >> 3] & (1 << (index & 7))))
+            missing[numMissing++] = d;
+    }
+    for (uint8_t r = 0; r < m; r++)
+    {
+        uint16_t repair = (uint16_t)block * m + r;
+        if (ctx.repairMap[repair >> 3] & (1 << (repair & 7)))
+            repairs[numRepairs++] = r;
+    }
+    if (numMissing == 0 || numRepairs < numMissing)
+        return;
+
+    // Whole slots are combined: the zero padding beyond the sender's chunk length stays zero
+    uint8_t stride = ctx.stride;
+    uint8_t *pDataBase = &m_arena[ctx.offset];
+    uint8_t *pRepairBase = pDataBase + ((uint16_t)ctx.lastIndex + 1) * stride;
+
+    // 1. Remove the known fragments from the repair frames that will be used
+    for (uint8_t a = 0; a < numMissing; a++)
+    {
+        uint8_t *pRepair = pRepairBase + ((uint16_t)block * m + repairs[a]) * stride;
+        for (uint8_t d = 0; d < count; d++)
+        {
+            uint16_t index = firstIndex + d;
+            if (ctx.bitmap[index >> 3] & (1 << (index & 7)))
+                gfMulAdd(pRepair, pDataBase + index * stride, fecCoef(k, repairs[a], d), stride);
+        }
+    }
+
+    // 2. Invert the Cauchy submatrix of the missing columns (Gauss-Jordan)
+    uint8_t mat[MU_FEC_MAX_BLOCK][MU_FEC_MAX_BLOCK];
+    uint8_t inv[MU_FEC_MAX_BLOCK][MU_FEC_MAX_BLOCK];
+    for (uint8_t a = 0; a < numMissing; a++)
+    {
+        for (uint8_t b = 0; b < numMissing; b++)
+        {
+            mat[a][b] = fecCoef(k, repairs[a], missing[b]);
+            inv[a][b] = (a == b) ? 1 : 0;
+        }
+    }
+    for (uint8_t col = 0; col < numMissing; col++)
+    {
+        uint8_t pivot = col;
+        while (mat[pivot][col] == 0)
+            pivot++; // Always found: Cauchy submatrices are non-singular
+        if (pivot != col)
+        {
+            for (uint8_t b = 0; b < numMissing; b++)
+            {
+                uint8_t t = mat[col][b];
+                mat[col][b] = mat[pivot][b];
+                mat[pivot][b] = t;
+                t = inv[col][b];
+                inv[col][b] = inv[pivot][b];
+                inv[pivot][b] = t;
+            }
+        }
+        uint8_t scale = gfInv(mat[col][col]);
+        for (uint8_t b = 0; b < numMissing; b++)
+        {
+            mat[col][b] = gfMul(mat[col][b], scale);
+            inv[col][b] = gfMul(inv[col][b], scale);
+        }
+        for (uint8_t a = 0; a < numMissing; a++)
+        {
+            uint8_t factor = mat[a][col];
+            if (a == col || factor == 0)
+                continue;
+            for (uint8_t b = 0; b < numMissing; b++)
+            {
+                mat[a][b] ^= gfMul(factor, mat[col][b]);
+                inv[a][b] ^= gfMul(factor, inv[col][b]);
+            }
+        }
+    }
+
+    // 3. Rebuild each missing fragment into its place in the arena
+    for (uint8_t b = 0; b < numMissing; b++)
+    {
+        uint16_t index = firstIndex + missing[b];
+        uint8_t *pDst = pDataBase + index * stride;
+        memset(pDst, 0, stride);
+        for (uint8_t a = 0; a < numMissing; a++)
+        {
+            const uint8_t *pRepair = pRepairBase + ((uint16_t)block * m + repairs[a]) * stride;
+            gfMulAdd(pDst, pRepair, inv[b][a], stride);
+        }
+        ctx.bitmap[index >> 3] |= (uint8_t)(1 << (index & 7));
+        ctx.received++;
+        m_stats.fragmentsRecovered++;
+    }
+}
+
+void MU_Fragmenter::m_CompleteIfDone(uint8_t ctxIndex)
+{
+    RxContext &ctx = m_rx[ctxIndex];
+    if (ctx.received != (uint16_t)ctx.lastIndex + 1)
+        return;
+
+    if (ctx.lastIndex > 0 && ctx.lastLen > ctx.chunkLen)
+    {
+        m_FreeContext(ctxIndex); // The last fragment came from a different sender configuration
+        return;
+    }
+
+    // Close the gaps left by slots wider than the sender's fragments
+    uint8_t *pBase = &m_arena[ctx.offset];
+    if (ctx.chunkLen != ctx.stride)
+    {
+        for (uint16_t i = 1; i <= ctx.lastIndex; i++)
+            memmove(pBase + i * ctx.chunkLen, pBase + i * ctx.stride, (i == ctx.lastIndex) ? ctx.lastLen : ctx.chunkLen);
+    }
+
+    m_stats.messagesReceived++;
+    uint32_t msgLen = (uint32_t)ctx.lastIndex * ctx.chunkLen + ctx.lastLen;
+    m_Notify(MU_Fragmenter_EventType::Received, ctx.source, ctx.messageId, pBase, msgLen);
+    m_FreeContext(ctxIndex);
+}
+
+bool MU_Fragmenter::m_CheckChunkLen(RxContext &ctx, uint8_t len)
+{
+    // Every full fragment of a message has the sender's chunk length; the first one seen sets it
+    if (ctx.chunkLen == 0)
+        ctx.chunkLen = len;
+    return len == ctx.chunkLen;
+}
+
+int8_t MU_Fragmenter::m_FindContext(uint8_t source, uint8_t messageId, uint8_t lastIndex, bool fec)
+{
+    for (uint8_t i = 0; i < MU_FRAG_MAX_MESSAGES; i++)
+    {
+        const RxContext &ctx = m_rx[i];
+        if (ctx.used && ctx.fec == fec && ctx.source == source && ctx.messageId == messageId && ctx.lastIndex == lastIndex)
+            return i;
+    }
+    return -1;
+}
+
+int8_t MU_Fragmenter::m_AllocContext(uint8_t source, uint8_t messageId, uint8_t lastIndex, uint8_t stride, uint16_t repairCount)
+{
+    uint32_t capacity = ((uint32_t)lastIndex + 1 + repairCount) * stride;
+    if (m_arenaUsed + capacity > MU_FRAG_ARENA_SIZE)
+        return -1;
+
+    for (uint8_t i = 0; i < MU_FRAG_MAX_MESSAGES; i++)
+    {
+        RxContext &ctx = m_rx[i];
+        if (ctx.used)
+            continue;
+
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.used = true;
+        ctx.source = source;
+        ctx.messageId = messageId;
+        ctx.lastIndex = lastIndex;
+        ctx.stride = stride;
+        ctx.offset = m_arenaUsed;
+        ctx.capacity = (uint16_t)capacity;
+        ctx.lastRxAt = millis();
+        m_arenaUsed += (uint16_t)capacity;
+        return i;
+    }
+    return -1;
+}
+
+void MU_Fragmenter::m_FreeContext(uint8_t index)
+{
+    // Compact the arena so free space always stays at the end
+    RxContext &ctx = m_rx[index];
+    uint16_t end = ctx.offset + ctx.capacity;
+    memmove(&m_arena[ctx.offset], &m_arena[end], m_arenaUsed - end);
+    for (uint8_t i = 0; i < MU_FRAG_MAX_MESSAGES; i++)
+    {
+        if (m_rx[i].used && m_rx[i].offset >= end)
+            m_rx[i].offset -= ctx.capacity;
+    }
+    m_arenaUsed -= ctx.capacity;
+    ctx.used = false;
+}
+
+void MU_Fragmenter::m_Notify(MU_Fragmenter_EventType type, uint8_t source, uint8_t messageId, const uint8_t *pData, uint32_t len)
+{
+    if (!m_pCallback)
+        return;
+    MU_Fragmenter_Event ev;
+    ev.type = type;
+    ev.source = source;
+    ev.messageId = messageId;
+    ev.pData = pData;
+    ev.len = len;
+    m_pCallback(ev);
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Fragmenter::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    (void)modem;
+
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        for (uint8_t i = 0; i < MU_TX_PIPELINE_DEPTH; i++)
+        {
+            TxFrame &frame = m_txFrames[i];
+            if (!frame.queued || event.pPayload != frame.buf)
+                continue;
+
+            frame.queued = false;
+            // A lost frame is only fatal without FEC; the repair frames cover it otherwise
+            if (event.type == MU_Modem_Response::TxFailed && !m_fecRepair)
+                m_txFailed = true;
+
+            bool anyQueued = false;
+            for (uint8_t j = 0; j < MU_TX_PIPELINE_DEPTH; j++)
+                anyQueued = anyQueued || m_txFrames[j].queued;
+
+            if (m_pTxData && !anyQueued && (m_txFailed || m_txNextIndex >= m_txSymbolCount))
+                m_FinishTx(m_txFailed ? MU_Fragmenter_EventType::SendFailed : MU_Fragmenter_EventType::SendComplete);
+            else
+                m_PumpTx();
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived)
+        return false;
+
+    if (event.payloadLen > MU_FRAG_HEADER_LEN && event.pPayload[0] == MU_PROTO_FRAGMENT)
+    {
+        m_OnFragment(event.pPayload, (uint8_t)event.payloadLen);
+        return true;
+    }
+    if (event.payloadLen > MU_FEC_HEADER_LEN && event.pPayload[0] == MU_PROTO_FEC)
+    {
+        m_OnFecFrame(event.pPayload, (uint8_t)event.payloadLen);
+        return true;
+    }
+    return false;
+}
+
+void MU_Fragmenter::OnModemWork(MU_Modem &modem)
+{
+    (void)modem;
+    if (!m_pModem)
+        return;
+
+    m_PumpTx();
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MU_FRAG_MAX_MESSAGES; i++)
+    {
+        RxContext &ctx = m_rx[i];
+        if (!ctx.used || (uint32_t)(now - ctx.lastRxAt) < MU_FRAG_REASSEMBLY_TIMEOUT_MS)
+            continue;
+
+        uint8_t source = ctx.source;
+        uint8_t messageId = ctx.messageId;
+        m_FreeContext(i);
+        m_stats.rxTimeouts++;
+        m_Notify(MU_Fragmenter_EventType::RxTimeout, source, messageId, nullptr, 0);
+    }
+}
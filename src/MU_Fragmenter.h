@@ -0,0 +1,226 @@
+/**
+ * @file MU_Fragmenter.h
+ * @brief Fragmentation and reassembly of messages larger than one MU frame.
+ *
+ * Splits a buffer of up to MU_FRAG_MAX_MESSAGE_LEN bytes into frames with a
+ * five-byte header, streams them through the modem's TX pipeline and
+ * reassembles them on the receiver in a bounded arena. An optional erasure
+ * coding mode adds Reed-Solomon repair frames for one-to-many broadcasts.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Size of the receive reassembly arena in bytes, shared by all messages in progress.
+ * A message takes its number of frames times MU_FRAG_CHUNK_LEN, or with FEC its data plus repair
+ * frames times MU_FEC_CHUNK_LEN (e.g. 4000 bytes with SetFec(8, 2): 23 frames, about 5.7 KB).
+ */
+#ifndef MU_FRAG_ARENA_SIZE
+#define MU_FRAG_ARENA_SIZE 2048
+#endif
+
+/**
+ * @brief Number of messages that can be reassembled at the same time.
+ */
+#ifndef MU_FRAG_MAX_MESSAGES
+#define MU_FRAG_MAX_MESSAGES 2
+#endif
+
+/**
+ * @brief Time without a new fragment after which a partial message is discarded (ms).
+ */
+#ifndef MU_FRAG_REASSEMBLY_TIMEOUT_MS
+#define MU_FRAG_REASSEMBLY_TIMEOUT_MS 3000
+#endif
+
+static constexpr uint8_t MU_FRAG_HEADER_LEN = 5;                                      //!< Header bytes per fragment
+static constexpr uint8_t MU_FRAG_CHUNK_LEN = MU_LAYER_PAYLOAD_LEN - MU_FRAG_HEADER_LEN; //!< Largest data bytes per fragment
+static constexpr uint32_t MU_FRAG_MAX_MESSAGE_LEN = 256UL * MU_FRAG_CHUNK_LEN;        //!< Largest message
+
+static constexpr uint8_t MU_FEC_HEADER_LEN = 8;                                     //!< Header bytes per frame in FEC mode
+static constexpr uint8_t MU_FEC_CHUNK_LEN = MU_LAYER_PAYLOAD_LEN - MU_FEC_HEADER_LEN; //!< Largest data bytes per frame in FEC mode
+static constexpr uint8_t MU_FEC_MAX_BLOCK = 15;                                     //!< Max data or repair frames per block
+
+/**
+ * @enum MU_Fragmenter_EventType
+ * @brief Types of events reported by MU_Fragmenter.
+ */
+enum class MU_Fragmenter_EventType
+{
+    Received,     //!< A complete message was reassembled. pData is only valid during the callback.
+    SendComplete, //!< All fragments of the message passed to Send() were transmitted.
+    SendFailed,   //!< A fragment could not be transmitted; the rest of the message was dropped.
+    RxTimeout     //!< A partial message was discarded after MU_FRAG_REASSEMBLY_TIMEOUT_MS.
+};
+
+/**
+ * @struct MU_Fragmenter_Event
+ * @brief Event passed to the MU_Fragmenter callback.
+ */
+struct MU_Fragmenter_Event
+{
+    MU_Fragmenter_EventType type; //!< Type of event.
+    uint8_t source;               //!< Node ID of the sender (own ID for send events).
+    uint8_t messageId;            //!< Message identifier chosen by the sender.
+    const uint8_t *pData;         //!< Message data (Received only).
+    uint32_t len;                 //!< Length of the message.
+};
+
+/**
+ * @typedef MU_Fragmenter_Callback
+ * @brief Callback function type for MU_Fragmenter events.
+ */
+typedef void (*MU_Fragmenter_Callback)(const MU_Fragmenter_Event &event);
+
+/**
+ * @struct MU_Fragmenter_Stats
+ * @brief Counters of the fragmentation layer.
+ */
+struct MU_Fragmenter_Stats
+{
+    uint32_t messagesSent;       //!< Messages completely transmitted.
+    uint32_t fragmentsSent;      //!< Fragments handed to the modem.
+    uint32_t messagesReceived;   //!< Messages completely reassembled.
+    uint32_t fragmentsReceived;  //!< Fragments accepted, duplicates excluded.
+    uint32_t rxTimeouts;         //!< Partial messages discarded on timeout.
+    uint32_t rxOverflows;        //!< Messages dropped because the arena or context table was full.
+    uint32_t repairsSent;        //!< FEC repair frames handed to the modem.
+    uint32_t fragmentsRecovered; //!< Missing fragments rebuilt from repair frames.
+};
+
+/**
+ * @class MU_Fragmenter
+ * @brief Fragmentation layer for MU_Modem.
+ *
+ * Fragments are sent with TransmitDataAsync(), so they may arrive out of order
+ * or not at all; a message is delivered only when every fragment has arrived.
+ * Attach the layer with begin(); fragment frames never reach the application's modem callback.
+ */
+class MU_Fragmenter : public MU_Modem_Layer
+{
+public:
+    MU_Fragmenter();
+
+    /**
+     * @brief Initializes the layer and attaches it to the driver.
+     * @param modem The driver to transmit through.
+     * @param nodeId Own node ID, used by receivers to tell senders apart.
+     * @param pCallback Callback for reassembled messages and send results.
+     * @return MU_Modem_Error::Ok on success.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t nodeId, MU_Fragmenter_Callback pCallback);
+
+    /**
+     * @brief Starts sending a message. Fragments are streamed from Work().
+     * The buffer is not copied and must stay valid until SendComplete or SendFailed.
+     * Fragments are sized to MU_Modem::GetMaxPayloadLen() at the time of the call, so enable
+     * encryption or the link tag before sending; receivers follow the sender's size.
+     * @param pData Message to send.
+     * @param len Length of the message (1 to 256 times the fragment data length, at most MU_FRAG_MAX_MESSAGE_LEN).
+     * @param pMessageId Optional output of the identifier assigned to the message.
+     * @return MU_Modem_Error::Ok if accepted, MU_Modem_Error::Busy if a message is still being sent,
+     * MU_Modem_Error::InvalidArg for bad arguments.
+     */
+    MU_Modem_Error Send(const uint8_t *pData, uint32_t len, uint8_t *pMessageId = nullptr);
+
+    /**
+     * @brief Enables erasure coding for subsequent Send() calls.
+     * Every block of dataPerBlock fragments is followed by repairPerBlock Reed-Solomon repair
+     * frames, and a receiver rebuilds the block from any dataPerBlock of them. No ACKs are
+     * needed, which suits GroupID broadcasts to many receivers. Receivers need no configuration,
+     * but their arena must also hold the repair frames.
+     * @param dataPerBlock Data fragments per block (1 to MU_FEC_MAX_BLOCK).
+     * @param repairPerBlock Repair frames per block (0 disables FEC, at most dataPerBlock).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::Busy while sending,
+     * MU_Modem_Error::InvalidArg for bad arguments.
+     */
+    MU_Modem_Error SetFec(uint8_t dataPerBlock, uint8_t repairPerBlock);
+
+    /**
+     * @brief Returns true while a message passed to Send() is being transmitted.
+     */
+    bool IsSending() const { return m_pTxData != nullptr; }
+
+    /**
+     * @brief Returns the layer counters.
+     */
+    const MU_Fragmenter_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the layer counters.
+     */
+    void ResetStats() { m_stats = MU_Fragmenter_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    struct TxFrame
+    {
+        bool queued;
+        uint8_t buf[MU_MAX_PAYLOAD_LEN];
+    };
+
+    struct RxContext
+    {
+        bool used;
+        bool fec;
+        uint8_t source;
+        uint8_t messageId;
+        uint8_t lastIndex;
+        uint8_t fecData;       // Data fragments per block (FEC only)
+        uint8_t fecRepair;     // Repair frames per block (FEC only)
+        uint8_t stride;        // Arena bytes per fragment slot: the largest chunk length of the mode
+        uint8_t chunkLen;      // Data bytes per full fragment as sent, 0 until one arrives
+        uint16_t received;     // Number of distinct data fragments stored or rebuilt
+        uint16_t offset;       // Start of the message in the arena; repair frames follow the data
+        uint16_t capacity;     // Bytes reserved in the arena
+        uint16_t lastLen;      // Data length of the final fragment (valid once known)
+        uint32_t lastRxAt;
+        uint8_t bitmap[32];    // Bit i: fragment i stored
+        uint8_t repairMap[32]; // Bit i: repair frame i (block * fecRepair + r) stored
+    };
+
+    void m_PumpTx();
+    uint8_t m_BuildFecFrame(uint8_t *pFrame, uint16_t symbol);
+    void m_FinishTx(MU_Fragmenter_EventType type);
+    void m_OnFragment(const uint8_t *pFrame, uint8_t len);
+    void m_OnFecFrame(const uint8_t *pFrame, uint8_t len);
+    int8_t m_FindContext(uint8_t source, uint8_t messageId, uint8_t lastIndex, bool fec);
+    void m_StoreFragment(uint8_t ctxIndex, uint8_t index, const uint8_t *pData, uint8_t len);
+    void m_TryRecoverBlock(RxContext &ctx, uint8_t block);
+    void m_CompleteIfDone(uint8_t ctxIndex);
+    bool m_CheckChunkLen(RxContext &ctx, uint8_t len);
+    int8_t m_AllocContext(uint8_t source, uint8_t messageId, uint8_t lastIndex, uint8_t stride, uint16_t repairCount);
+    void m_FreeContext(uint8_t index);
+    void m_Notify(MU_Fragmenter_EventType type, uint8_t source, uint8_t messageId, const uint8_t *pData, uint32_t len);
+
+    MU_Modem *m_pModem;
+    MU_Fragmenter_Callback m_pCallback;
+    uint8_t m_nodeId;
+
+    // Transmit state: one message at a time, up to MU_TX_PIPELINE_DEPTH fragments queued
+    const uint8_t *m_pTxData;
+    uint32_t m_txLen;
+    uint8_t m_txMessageId;
+    uint8_t m_txLastIndex;
+    uint8_t m_txChunkLen;     // Data bytes per full fragment, fixed at Send()
+    uint16_t m_txNextIndex;   // Next fragment, or next FEC symbol (block * (k + m) + j)
+    uint16_t m_txSymbolCount; // Frames to send for the message
+    bool m_txFailed;
+    uint8_t m_fecData;
+    uint8_t m_fecRepair;
+    TxFrame m_txFrames[MU_TX_PIPELINE_DEPTH];
+
+    // Receive state
+    RxContext m_rx[MU_FRAG_MAX_MESSAGES];
+    uint8_t m_arena[MU_FRAG_ARENA_SIZE];
+    uint16_t m_arenaUsed;
+
+    MU_Fragmenter_Stats m_stats;
+};
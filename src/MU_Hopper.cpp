@@ -0,0 +1,336 @@
+//
+// MU_Hopper.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Hopper.h"
+#include <string.h>
+
+// --- Sync Frame Layout ---
+// [0] MU_PROTO_HOP
+// [1] Seed of the hop sequence
+// [2..3] Position in the hop sequence of the current dwell, big endian
+// [4..5] Dwell time [ms], big endian
+// [6..] Blacklist in effect from the next dwell (bit n = channel min + n)
+static constexpr uint8_t HOP_OFS_SEED = 1;
+static constexpr uint8_t HOP_OFS_INDEX = 2;
+static constexpr uint8_t HOP_OFS_DWELL = 4;
+static constexpr uint8_t HOP_OFS_MASK = 6;
+
+MU_Hopper::MU_Hopper()
+    : m_pModem(nullptr), m_config(), m_leader(false), m_running(false), m_synced(false), m_syncPending(false),
+      m_hopPending(false), m_scanPending(false), m_chMin(0), m_numChannels(0), m_channel(0), m_index(0),
+      m_dwellStart(0), m_lastSync(0), m_lastScan(0), m_sequence(), m_active(), m_activeCount(0), m_mask(),
+      m_nextMask(), m_scanMask(), m_frame(), m_stats()
+{
+}
+
+MU_Modem_Error MU_Hopper::begin(MU_Modem &modem, bool leader, const MU_Hopper_Config &config)
+{
+    if (config.dwellMs == 0 || config.minChannels == 0 || config.maxMissedSyncs == 0)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_config = config;
+    m_leader = leader;
+    if (modem.GetFrequencyModel() == MU_Modem_FrequencyModel::MHz_429)
+    {
+        m_chMin = MU_CHANNEL_MIN_429;
+        m_numChannels = MU_CHANNEL_MAX_429 - MU_CHANNEL_MIN_429 + 1;
+    }
+    else
+    {
+        m_chMin = MU_CHANNEL_MIN_1216;
+        m_numChannels = MU_CHANNEL_MAX_1216 - MU_CHANNEL_MIN_1216 + 1;
+    }
+
+    memset(m_mask, 0, sizeof(m_mask));
+    memset(m_nextMask, 0, sizeof(m_nextMask));
+    memset(m_scanMask, 0, sizeof(m_scanMask));
+    m_BuildSequence();
+    m_BuildActive();
+    m_stats = MU_Hopper_Stats();
+
+    // The leader starts hopping right away; followers wait on the rendezvous channel for a sync frame
+    m_running = true;
+    m_synced = leader;
+    m_syncPending = false;
+    m_scanPending = false;
+    m_hopPending = true;
+    m_channel = 0;
+    m_index = 0;
+    m_dwellStart = millis();
+    m_lastSync = millis();
+    m_lastScan = millis();
+
+    return modem.AttachLayer(this);
+}
+
+MU_Modem_Error MU_Hopper::ScanChannels()
+{
+    if (!m_pModem || !m_leader)
+        return MU_Modem_Error::InvalidArg;
+    if (m_scanPending)
+        return MU_Modem_Error::Ok;
+
+    MU_Modem_Error err = m_pModem->GetAllChannelsRssiAsync();
+    if (err == MU_Modem_Error::Ok)
+        m_scanPending = true;
+    m_lastScan = millis();
+    return err;
+}
+
+bool MU_Hopper::IsBlacklisted(uint8_t channel) const
+{
+    uint8_t n = (uint8_t)(channel - m_chMin);
+    if (channel < m_chMin || n >= m_numChannels)
+        return false;
+    return (m_mask[n / 8] >> (n % 8)) & 1;
+}
+
+void MU_Hopper::ResetStats()
+{
+    uint8_t blacklisted = m_stats.blacklisted;
+    m_stats = MU_Hopper_Stats();
+    m_stats.blacklisted = blacklisted;
+}
+
+void MU_Hopper::m_BuildSequence()
+{
+    // Fisher-Yates shuffle driven by a 16-bit LCG, so every platform derives the same order from the seed
+    for (uint8_t i = 0; i < m_numChannels; i++)
+        m_sequence[i] = i;
+
+    uint16_t state = (uint16_t)(0xACE1 ^ (m_config.seed * 0x0101));
+    for (uint8_t i = m_numChannels - 1; i > 0; i--)
+    {
+        state = (uint16_t)(state * 25173U + 13849U);
+        uint8_t j = (uint8_t)((state >> 8) % (i + 1));
+        uint8_t t = m_sequence[i];
+        m_sequence[i] = m_sequence[j];
+        m_sequence[j] = t;
+    }
+}
+
+void MU_Hopper::m_BuildActive()
+{
+    // The rendezvous channel is never left out, so the leader comes by it once per cycle
+    uint8_t rendezvous = m_sequence[0];
+    m_mask[rendezvous / 8] &= (uint8_t)~(1 << (rendezvous % 8));
+
+    m_activeCount = 0;
+    for (uint8_t i = 0; i < m_numChannels; i++)
+    {
+        uint8_t n = m_sequence[i];
+        if (!((m_mask[n / 8] >> (n % 8)) & 1))
+            m_active[m_activeCount++] = n;
+    }
+    m_stats.blacklisted = (uint8_t)(m_numChannels - m_activeCount);
+
+    // A corrupt blacklist must never leave nothing to hop on
+    if (m_activeCount == 0)
+    {
+        memcpy(m_active, m_sequence, m_numChannels);
+        m_activeCount = m_numChannels;
+    }
+}
+
+void MU_Hopper::m_ApplyScan(const uint8_t *pHex, uint16_t len)
+{
+    // *RC= payload: two hex digits of -RSSI [dBm] per channel, lowest channel first
+    uint8_t mask[MU_HOP_MASK_LEN] = {};
+    uint8_t quiet = 0;
+    for (uint8_t n = 0; n < m_numChannels; n++)
+    {
+        if ((uint16_t)(n * 2 + 2) > len)
+            return; // Incomplete response
+        uint8_t value = 0;
+        for (uint8_t k = 0; k < 2; k++)
+        {
+            uint8_t c = pHex[n * 2 + k];
+            uint8_t digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : 0xFF;
+            if (digit == 0xFF)
+                return;
+            value = (uint8_t)((value << 4) | digit);
+        }
+        if (-(int16_t)value >= m_config.busyRssiDbm)
+            mask[n / 8] |= (uint8_t)(1 << (n % 8));
+        else
+            quiet++;
+    }
+
+    m_stats.scans++;
+    if (quiet < m_config.minChannels)
+        return; // Wideband noise: hopping around it would not help
+    mask[m_sequence[0] / 8] &= (uint8_t)~(1 << (m_sequence[0] % 8)); // Rendezvous channel
+    memcpy(m_scanMask, mask, sizeof(m_scanMask));
+}
+
+void MU_Hopper::m_Hop()
+{
+    uint8_t channel = (uint8_t)(m_chMin + m_active[m_index % m_activeCount]);
+    if (channel != m_channel)
+    {
+        if (m_pModem->SetChannelAsync(channel, MU_Modem_Priority::UrgentTx) != MU_Modem_Error::Ok)
+            return; // Queue full: retried on the next Work()
+        m_channel = channel;
+        m_stats.hops++;
+    }
+    m_hopPending = false;
+
+    if (m_leader)
+        m_SendSync();
+}
+
+void MU_Hopper::m_Rendezvous()
+{
+    uint8_t channel = (uint8_t)(m_chMin + m_sequence[0]);
+    if (channel != m_channel)
+    {
+        if (m_pModem->SetChannelAsync(channel, MU_Modem_Priority::UrgentTx) != MU_Modem_Error::Ok)
+            return; // Queue full: retried on the next Work()
+        m_channel = channel;
+        m_stats.hops++;
+    }
+    m_hopPending = false;
+}
+
+void MU_Hopper::m_SendSync()
+{
+    if (m_syncPending)
+        return;
+
+    // Announce the latest scan; it takes effect at the next hop on every node at once
+    memcpy(m_nextMask, m_scanMask, sizeof(m_nextMask));
+
+    m_frame[0] = MU_PROTO_HOP;
+    m_frame[HOP_OFS_SEED] = m_config.seed;
+    m_frame[HOP_OFS_INDEX] = (uint8_t)(m_index >> 8);
+    m_frame[HOP_OFS_INDEX + 1] = (uint8_t)m_index;
+    m_frame[HOP_OFS_DWELL] = (uint8_t)(m_config.dwellMs >> 8);
+    m_frame[HOP_OFS_DWELL + 1] = (uint8_t)m_config.dwellMs;
+    memcpy(&m_frame[HOP_OFS_MASK], m_nextMask, MU_HOP_MASK_LEN);
+
+    // Same class as the channel command, so it goes out on the new channel
+    if (m_pModem->TransmitDataAsync(m_frame, MU_HOP_SYNC_LEN, false, MU_Modem_Priority::UrgentTx) == MU_Modem_Error::Ok)
+    {
+        m_syncPending = true;
+        m_stats.syncSent++;
+    }
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Hopper::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    switch (event.type)
+    {
+    case MU_Modem_Response::TxComplete:
+    case MU_Modem_Response::TxFailed:
+        if (m_syncPending && event.pPayload == m_frame)
+        {
+            m_syncPending = false;
+            return true;
+        }
+        return false;
+
+    case MU_Modem_Response::RssiAllChannels:
+        if (m_scanPending)
+        {
+            m_scanPending = false;
+            if (event.error == MU_Modem_Error::Ok && event.pPayload)
+                m_ApplyScan(event.pPayload, event.payloadLen);
+        }
+        return false; // The application may have asked for a scan as well
+
+    case MU_Modem_Response::DataReceived:
+        break;
+
+    default:
+        return false;
+    }
+
+    if (event.payloadLen < MU_HOP_SYNC_LEN || event.pPayload[0] != MU_PROTO_HOP)
+        return false;
+    if (m_leader)
+        return true;
+
+    const uint8_t *pFrame = event.pPayload;
+    uint16_t dwellMs = (uint16_t)((pFrame[HOP_OFS_DWELL] << 8) | pFrame[HOP_OFS_DWELL + 1]);
+    if (dwellMs == 0)
+        return true;
+
+    if (pFrame[HOP_OFS_SEED] != m_config.seed)
+    {
+        m_config.seed = pFrame[HOP_OFS_SEED];
+        m_BuildSequence();
+        m_BuildActive();
+    }
+    m_config.dwellMs = dwellMs;
+    m_index = (uint16_t)((pFrame[HOP_OFS_INDEX] << 8) | pFrame[HOP_OFS_INDEX + 1]);
+    memcpy(m_nextMask, &pFrame[HOP_OFS_MASK], MU_HOP_MASK_LEN);
+
+    // The leader's dwell began when it queued this frame, just before the frame went on air
+    uint32_t airStartUs;
+    uint32_t agoMs = 0;
+    if (modem.EstimateAirTime(event, &airStartUs, nullptr) == MU_Modem_Error::Ok)
+        agoMs = (micros() - airStartUs) / 1000;
+    m_dwellStart = millis() - agoMs;
+    m_lastSync = millis();
+
+    // Receiving it proves we are on the leader's channel; before synchronization we did not know which one that was
+    if (!m_synced)
+        m_channel = 0;
+    m_hopPending = false;
+    m_synced = true;
+    m_stats.syncReceived++;
+    return true;
+}
+
+void MU_Hopper::OnModemWork(MU_Modem &modem)
+{
+    (void)modem;
+    if (!m_pModem || !m_running)
+        return;
+
+    uint32_t now = millis();
+    if (m_leader && m_config.scanIntervalMs && now - m_lastScan >= m_config.scanIntervalMs)
+        ScanChannels();
+
+    if (!m_leader && m_synced && now - m_lastSync > (uint32_t)m_config.maxMissedSyncs * m_config.dwellMs)
+    {
+        // Wait on the rendezvous channel: the blacklist we knew may be stale, but the leader
+        // never leaves that channel out and resynchronizes us there within one cycle
+        m_synced = false;
+        m_stats.syncLost++;
+        memset(m_mask, 0, sizeof(m_mask));
+        memset(m_nextMask, 0, sizeof(m_nextMask));
+        m_BuildActive();
+        m_hopPending = true;
+    }
+    if (!m_synced)
+    {
+        if (m_hopPending)
+            m_Rendezvous();
+        return;
+    }
+
+    uint32_t elapsed = now - m_dwellStart;
+    if (elapsed >= m_config.dwellMs)
+    {
+        uint32_t steps = elapsed / m_config.dwellMs;
+        m_dwellStart += steps * m_config.dwellMs;
+        m_index = (uint16_t)(m_index + steps);
+        memcpy(m_mask, m_nextMask, sizeof(m_mask));
+        m_BuildActive();
+        m_hopPending = true;
+    }
+
+    if (m_hopPending)
+        m_Hop();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file MU_Hopper.h
+ * @brief Coordinated frequency hopping over the model's channel range.
+ *
+ * All nodes derive the same pseudo-random permutation of the channels from a
+ * shared seed and step through it once per dwell time with volatile channel
+ * commands queued from Work(), so a hop never blocks the caller. A leader
+ * node announces the seed, its position in the sequence and the channel
+ * blacklist on every channel it visits; followers adopt them and hop in step.
+ * Channels the RSSI scanner (@RC) finds busy are left out of the sequence.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+static constexpr uint8_t MU_HOP_MAX_CHANNELS = MU_CHANNEL_MAX_429 - MU_CHANNEL_MIN_429 + 1; //!< Channels of the largest model
+static constexpr uint8_t MU_HOP_MASK_LEN = (MU_HOP_MAX_CHANNELS + 7) / 8;                  //!< Blacklist bitmap bytes
+static constexpr uint8_t MU_HOP_SYNC_LEN = 6 + MU_HOP_MASK_LEN;                            //!< Sync frame payload bytes
+
+/**
+ * @struct MU_Hopper_Config
+ * @brief Hopping parameters. Followers take seed, dwell time and blacklist from the leader.
+ */
+struct MU_Hopper_Config
+{
+    uint16_t dwellMs = 2000;        //!< Time spent on each channel [ms] (leader).
+    uint8_t seed = 0x5A;            //!< Seed of the hop sequence (leader).
+    int16_t busyRssiDbm = -100;     //!< Channels scanned at or above this level are blacklisted [dBm] (leader).
+    uint8_t minChannels = 4;        //!< A scan leaving fewer usable channels is ignored (leader).
+    uint32_t scanIntervalMs = 0;    //!< Period of automatic scans [ms], 0 = only ScanChannels() (leader).
+    uint8_t maxMissedSyncs = 4;     //!< Dwell times without sync after which a follower stops hopping.
+};
+
+/**
+ * @struct MU_Hopper_Stats
+ * @brief Counters of the hopping engine.
+ */
+struct MU_Hopper_Stats
+{
+    uint32_t hops;         //!< Channel changes queued.
+    uint32_t syncSent;     //!< Sync frames queued (leader).
+    uint32_t syncReceived; //!< Sync frames received (follower).
+    uint32_t syncLost;     //!< Times a follower lost the leader.
+    uint32_t scans;        //!< RSSI scans evaluated.
+    uint8_t blacklisted;   //!< Channels currently left out of the sequence.
+};
+
+/**
+ * @class MU_Hopper
+ * @brief Frequency hopping layer for MU_Modem.
+ *
+ * Channel commands are queued in the UrgentTx class, so they go out ahead of waiting data
+ * frames but never interrupt a frame already handed to the modem. A follower waits for the
+ * leader on the rendezvous channel (the first channel of the hop sequence), both after begin()
+ * and after losing sync; that channel is never blacklisted, so the leader visits it once per
+ * cycle and resynchronizes the follower there. A scan occupies the modem for several seconds, during
+ * which hops are delayed.
+ */
+class MU_Hopper : public MU_Modem_Layer
+{
+public:
+    MU_Hopper();
+
+    /**
+     * @brief Initializes hopping and attaches the layer to the driver.
+     * @param modem The driver.
+     * @param leader True for the node that sets the timing (exactly one per network).
+     * @param config Hopping parameters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the configuration is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, bool leader, const MU_Hopper_Config &config = MU_Hopper_Config());
+
+    /**
+     * @brief Stops hopping. The modem stays on its current channel.
+     */
+    void Stop() { m_running = false; }
+
+    /**
+     * @brief Starts an RSSI scan of all channels; busy channels are blacklisted when it completes (leader).
+     * @return MU_Modem_Error::Ok if the scan was queued.
+     */
+    MU_Modem_Error ScanChannels();
+
+    /**
+     * @brief Returns true while hopping in step with the leader (always true on the leader).
+     */
+    bool IsSynchronized() const { return m_synced; }
+
+    /**
+     * @brief Returns the channel the hopper last switched to (0 before the first hop).
+     */
+    uint8_t GetChannel() const { return m_channel; }
+
+    /**
+     * @brief Returns true if a channel is left out of the hop sequence.
+     * @param channel Channel number.
+     */
+    bool IsBlacklisted(uint8_t channel) const;
+
+    /**
+     * @brief Returns the hopping counters.
+     */
+    const MU_Hopper_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the hopping counters (blacklisted is kept).
+     */
+    void ResetStats();
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    void m_BuildSequence();
+    void m_BuildActive();
+    void m_ApplyScan(const uint8_t *pHex, uint16_t len);
+    void m_SendSync();
+    void m_Hop();
+    void m_Rendezvous();
+
+    MU_Modem *m_pModem;
+    MU_Hopper_Config m_config;
+    bool m_leader;
+    bool m_running;
+    bool m_synced;
+    bool m_syncPending;  // m_frame is queued in the modem (leader)
+    bool m_hopPending;   // The channel of the current dwell still has to be set
+    bool m_scanPending;  // An @RC scan of ours is queued
+    uint8_t m_chMin;
+    uint8_t m_numChannels;
+    uint8_t m_channel;
+    uint16_t m_index;    // Position in the hop sequence
+    uint32_t m_dwellStart;
+    uint32_t m_lastSync;
+    uint32_t m_lastScan;
+    uint8_t m_sequence[MU_HOP_MAX_CHANNELS]; // Channel offsets in hop order
+    uint8_t m_active[MU_HOP_MAX_CHANNELS];   // m_sequence without blacklisted channels
+    uint8_t m_activeCount;
+    uint8_t m_mask[MU_HOP_MASK_LEN];         // Bit n: channel m_chMin + n is blacklisted
+    uint8_t m_nextMask[MU_HOP_MASK_LEN];     // Blacklist announced for the next dwell
+    uint8_t m_scanMask[MU_HOP_MASK_LEN];     // Result of the last scan, announced next (leader)
+    uint8_t m_frame[MU_HOP_SYNC_LEN];
+    MU_Hopper_Stats m_stats;
+};
@@ -0,0 +1,281 @@
+//
+// MU_LinkAdapter.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_LinkAdapter.h"
+#include <string.h>
+
+// EWMA weight 1/8 for all smoothed values
+static constexpr uint8_t LA_EWMA_SHIFT = 3;
+
+static int16_t laEwmaStep(int16_t diff)
+{
+    // diff / 8 rounded to nearest, and at least one unit: a truncated step stalls up to 7 units
+    // short of a steady sample, so the delivery ratio would never return to 100 %
+    const int16_t half = 1 << (LA_EWMA_SHIFT - 1);
+    int16_t step = (int16_t)((diff + (diff > 0 ? half : -half)) / (1 << LA_EWMA_SHIFT));
+    if (step == 0 && diff != 0)
+        step = (diff > 0) ? 1 : -1;
+    return step;
+}
+
+static uint32_t laIsqrt(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > x)
+        bit >>= 2;
+    while (bit)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+MU_LinkAdapter::MU_LinkAdapter()
+    : m_pModem(nullptr), m_config(), m_peers(), m_modemPower(0), m_lbtFailQ8(0), m_stats()
+{
+}
+
+MU_Modem_Error MU_LinkAdapter::begin(MU_Modem &modem, const MU_LinkAdapter_Config &config)
+{
+    if (config.minFrameLen == 0 || config.minFrameLen > config.maxFrameLen)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_config = config;
+    memset(m_peers, 0, sizeof(m_peers));
+    m_modemPower = 0;
+    m_lbtFailQ8 = 0;
+    m_stats = MU_LinkAdapter_Stats();
+
+    return modem.AttachLayer(this);
+}
+
+void MU_LinkAdapter::ReportRssi(uint8_t peer, int16_t rssiDbm)
+{
+    Peer &p = m_GetPeer(peer);
+    int16_t sampleQ4 = (int16_t)(rssiDbm * 16);
+    if (!p.rssiValid)
+    {
+        p.rssiQ4 = sampleQ4;
+        p.rssiValid = true;
+    }
+    else
+    {
+        p.rssiQ4 += laEwmaStep((int16_t)(sampleQ4 - p.rssiQ4));
+    }
+    p.lastSeen = millis();
+}
+
+void MU_LinkAdapter::ReportDelivery(uint8_t peer, uint8_t len, bool delivered)
+{
+    Peer &p = m_GetPeer(peer);
+    int16_t sample = delivered ? 256 : 0;
+    p.deliveryQ8 = (uint16_t)(p.deliveryQ8 + laEwmaStep((int16_t)(sample - (int16_t)p.deliveryQ8)));
+    p.avgLen = (uint16_t)(p.avgLen + laEwmaStep((int16_t)((int16_t)len - (int16_t)p.avgLen)));
+    if (p.samples < 0xFF)
+        p.samples++;
+    p.lastSeen = millis();
+    m_Evaluate(p);
+}
+
+MU_Modem_Error MU_LinkAdapter::PrepareTx(uint8_t peer, MU_Modem_Priority priority)
+{
+    if (!m_pModem)
+        return MU_Modem_Error::InvalidArg;
+
+    const Peer *p = m_FindPeer(peer);
+    uint8_t power = p ? p->power : MU_LA_POWER_HIGH;
+    if (power == m_modemPower)
+        return MU_Modem_Error::Ok;
+
+    MU_Modem_Error err = m_pModem->SetPowerAsync(power, priority);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_modemPower = power;
+        m_stats.powerCommands++;
+    }
+    return err;
+}
+
+uint8_t MU_LinkAdapter::GetFrameLen(uint8_t peer) const
+{
+    const Peer *p = m_FindPeer(peer);
+    uint8_t len = p ? p->frameLen : m_config.maxFrameLen;
+    if (m_pModem && len > GetLayerFrameLen(*m_pModem))
+        len = GetLayerFrameLen(*m_pModem); // Room for the driver's framing
+    return len;
+}
+
+MU_Modem_Error MU_LinkAdapter::GetPeerInfo(uint8_t peer, MU_LinkAdapter_PeerInfo *pInfo) const
+{
+    const Peer *p = m_FindPeer(peer);
+    if (!pInfo || !p)
+        return MU_Modem_Error::InvalidArg;
+
+    pInfo->rssiDbm = p->rssiValid ? (int16_t)(p->rssiQ4 / 16) : 0;
+    pInfo->deliveryPct = (uint8_t)(((uint32_t)p->deliveryQ8 * 100) >> 8);
+    pInfo->frameLen = p->frameLen;
+    pInfo->power = p->power;
+    return MU_Modem_Error::Ok;
+}
+
+MU_LinkAdapter::Peer *MU_LinkAdapter::m_FindPeer(uint8_t peer)
+{
+    for (uint8_t i = 0; i < MU_LA_MAX_PEERS; i++)
+    {
+        if (m_peers[i].used && m_peers[i].id == peer)
+            return &m_peers[i];
+    }
+    return nullptr;
+}
+
+const MU_LinkAdapter::Peer *MU_LinkAdapter::m_FindPeer(uint8_t peer) const
+{
+    return const_cast<MU_LinkAdapter *>(this)->m_FindPeer(peer);
+}
+
+MU_LinkAdapter::Peer &MU_LinkAdapter::m_GetPeer(uint8_t peer)
+{
+    Peer *p = m_FindPeer(peer);
+    if (p)
+        return *p;
+
+    // New peer: take a free entry or the least recently seen one. Start safe: full power, largest frames.
+    p = &m_peers[0];
+    for (uint8_t i = 0; i < MU_LA_MAX_PEERS; i++)
+    {
+        if (!m_peers[i].used)
+        {
+            p = &m_peers[i];
+            break;
+        }
+        if ((int32_t)(m_peers[i].lastSeen - p->lastSeen) < 0)
+            p = &m_peers[i];
+    }
+    memset(p, 0, sizeof(*p));
+    p->used = true;
+    p->id = peer;
+    p->power = MU_LA_POWER_HIGH;
+    p->frameLen = m_config.maxFrameLen;
+    p->deliveryQ8 = 256;
+    p->avgLen = m_config.maxFrameLen;
+    p->lastPowerChange = millis();
+    p->lastSeen = millis();
+    return *p;
+}
+
+void MU_LinkAdapter::m_Evaluate(Peer &p)
+{
+    if (p.samples < m_config.minSamples)
+        return;
+
+    bool decided = false;
+
+    // Frame size: only moves by at least the hysteresis
+    uint8_t len = m_OptimalFrameLen(p);
+    uint8_t diff = (len > p.frameLen) ? len - p.frameLen : p.frameLen - len;
+    if (diff >= m_config.sizeHysteresis || (diff > 0 && (len == m_config.minFrameLen || len == m_config.maxFrameLen)))
+    {
+        p.frameLen = len;
+        m_stats.sizeChanges++;
+        decided = true;
+    }
+
+    // Power: step down only on a strong, reliable link over a quiet channel; step back up on any sign of trouble
+    uint32_t now = millis();
+    if (now - p.lastPowerChange >= m_config.minHoldMs)
+    {
+        uint32_t deliveryPct = ((uint32_t)p.deliveryQ8 * 100) >> 8;
+        int16_t rssi = (int16_t)(p.rssiQ4 / 16);
+        uint8_t power = p.power;
+        if (p.power == MU_LA_POWER_HIGH)
+        {
+            if (p.rssiValid && rssi >= m_config.lowPowerRssiDbm && deliveryPct >= m_config.minDeliveryPct &&
+                GetLbtFailurePct() <= m_config.maxLbtFailurePct)
+                power = MU_LA_POWER_LOW;
+        }
+        else if ((p.rssiValid && rssi < m_config.lowPowerRssiDbm - m_config.powerHysteresisDb) ||
+                 deliveryPct < m_config.minDeliveryPct)
+        {
+            power = MU_LA_POWER_HIGH;
+        }
+
+        if (power != p.power)
+        {
+            p.power = power;
+            p.lastPowerChange = now;
+            m_stats.powerChanges++;
+            decided = true;
+        }
+    }
+
+    // Judge the new setting on fresh reports only
+    if (decided)
+        p.samples = 0;
+}
+
+uint8_t MU_LinkAdapter::m_OptimalFrameLen(const Peer &p) const
+{
+    // Goodput of a frame of L bytes with H bytes of overhead and byte error rate b:
+    //   G(L) = L / (L + H) * (1 - b)^(L + H)
+    // maximized at L = (sqrt(H^2 + 4H / b) - H) / 2. b is estimated from the delivery ratio d
+    // observed at the average length A (overhead included) as b ~ (1 - d) / A.
+    uint32_t lossQ8 = 256 - p.deliveryQ8;
+    if (lossQ8 == 0)
+        return m_config.maxFrameLen;
+
+    uint32_t h = m_config.frameOverheadBytes ? m_config.frameOverheadBytes : 1;
+    uint32_t a = p.avgLen + h;
+    uint32_t root = laIsqrt(h * h + (4 * h * a * 256) / lossQ8);
+    uint32_t len = (root > h) ? (root - h) / 2 : 0;
+
+    if (len < m_config.minFrameLen)
+        return m_config.minFrameLen;
+    if (len > m_config.maxFrameLen)
+        return m_config.maxFrameLen;
+    return (uint8_t)len;
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_LinkAdapter::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    (void)modem;
+    switch (event.type)
+    {
+    case MU_Modem_Response::DataReceived:
+        // The first route node is the originator (needs route information in *DR)
+        if (event.numRouteNodes > 0 && event.pRouteNodes)
+            ReportRssi(event.pRouteNodes[0], (int16_t)event.value);
+        break;
+
+    case MU_Modem_Response::TxComplete:
+    case MU_Modem_Response::TxFailed:
+    {
+        int16_t sample = (event.error == MU_Modem_Error::FailLbt) ? 256 : 0;
+        m_lbtFailQ8 = (uint16_t)(m_lbtFailQ8 + laEwmaStep((int16_t)(sample - (int16_t)m_lbtFailQ8)));
+        break;
+    }
+
+    default:
+        break;
+    }
+    return false; // Observer only
+}
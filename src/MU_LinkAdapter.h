@@ -0,0 +1,179 @@
+/**
+ * @file MU_LinkAdapter.h
+ * @brief Per-peer frame size and transmit power selection from link statistics.
+ *
+ * Tracks the RSSI of each peer's frames, the delivery ratio of frames sent to
+ * it and the LBT failure rate of the channel, and derives the frame size that
+ * maximizes goodput and the lowest transmit power that keeps the link healthy.
+ * Power changes go through SetPowerAsync() (RAM only, never NVM) and are
+ * damped by hysteresis and a minimum hold time.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Number of peers whose link statistics are tracked at the same time.
+ */
+#ifndef MU_LA_MAX_PEERS
+#define MU_LA_MAX_PEERS 8
+#endif
+
+static constexpr uint8_t MU_LA_POWER_LOW = 0x01;  //!< 1 mW
+static constexpr uint8_t MU_LA_POWER_HIGH = 0x10; //!< 10 mW
+
+/**
+ * @struct MU_LinkAdapter_Config
+ * @brief Thresholds of the link adaptation.
+ */
+struct MU_LinkAdapter_Config
+{
+    uint8_t minFrameLen = 32;                               //!< Smallest frame size ever recommended.
+    uint8_t maxFrameLen = MU_LAYER_PAYLOAD_LEN;             //!< Largest frame size ever recommended.
+    uint8_t frameOverheadBytes = MU_AIRTIME_OVERHEAD_BYTES; //!< Fixed cost of a frame in byte times (preamble, LBT, headers).
+    uint8_t sizeHysteresis = 16;                            //!< Minimum change of the frame size worth applying [bytes].
+    int16_t lowPowerRssiDbm = -80;                          //!< Peers heard at least this strong are served with low power.
+    uint8_t powerHysteresisDb = 6;                          //!< Back to high power only below lowPowerRssiDbm minus this.
+    uint8_t minDeliveryPct = 90;                            //!< Delivery ratio below which high power is restored.
+    uint8_t maxLbtFailurePct = 20;                          //!< Busy channel: no step down above this LBT failure rate.
+    uint8_t minSamples = 8;                                 //!< Delivery reports needed between two decisions.
+    uint32_t minHoldMs = 10000;                             //!< Minimum time between power changes of a peer [ms].
+};
+
+/**
+ * @struct MU_LinkAdapter_PeerInfo
+ * @brief Link state of one peer.
+ */
+struct MU_LinkAdapter_PeerInfo
+{
+    int16_t rssiDbm;     //!< Smoothed RSSI of the peer's frames (0 if none received yet).
+    uint8_t deliveryPct; //!< Smoothed delivery ratio of frames sent to the peer.
+    uint8_t frameLen;    //!< Recommended frame size.
+    uint8_t power;       //!< Selected power (MU_LA_POWER_LOW or MU_LA_POWER_HIGH).
+};
+
+/**
+ * @struct MU_LinkAdapter_Stats
+ * @brief Counters of the link adaptation.
+ */
+struct MU_LinkAdapter_Stats
+{
+    uint32_t powerChanges;  //!< Power decisions changed for a peer.
+    uint32_t sizeChanges;   //!< Frame size recommendations changed for a peer.
+    uint32_t powerCommands; //!< SetPowerAsync() commands issued by PrepareTx().
+};
+
+/**
+ * @class MU_LinkAdapter
+ * @brief Link adaptation layer for MU_Modem.
+ *
+ * The layer only observes events: RSSI is taken from DataReceived events whose route
+ * information names the sender, LBT failures from TxFailed events. Delivery results are
+ * reported by the application (e.g. from the MU_ReliableLink Acked/Failed events), and
+ * peers identified by a layer node ID rather than the route information can report RSSI
+ * with ReportRssi(). Before sending to a peer, call PrepareTx() to apply its power and
+ * GetFrameLen() to size the frame.
+ */
+class MU_LinkAdapter : public MU_Modem_Layer
+{
+public:
+    MU_LinkAdapter();
+
+    /**
+     * @brief Initializes the adapter and attaches it to the driver.
+     * @param modem The driver to observe and configure.
+     * @param config Adaptation thresholds.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the frame size range is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, const MU_LinkAdapter_Config &config = MU_LinkAdapter_Config());
+
+    /**
+     * @brief Records the RSSI of a frame received from a peer.
+     * @param peer Peer ID.
+     * @param rssiDbm RSSI of the frame [dBm].
+     */
+    void ReportRssi(uint8_t peer, int16_t rssiDbm);
+
+    /**
+     * @brief Records whether a frame sent to a peer was delivered.
+     * @param peer Peer ID.
+     * @param len Payload length of the frame.
+     * @param delivered True if the peer confirmed the frame.
+     */
+    void ReportDelivery(uint8_t peer, uint8_t len, bool delivered);
+
+    /**
+     * @brief Applies the transmit power selected for a peer.
+     * Issues SetPowerAsync() in the given queue class only if the modem runs at a different power,
+     * so the command is dispatched before data frames queued afterwards in the same class.
+     * @param peer Peer ID.
+     * @param priority Queue class of the data frames that follow.
+     * @return MU_Modem_Error::Ok on success, or the error of SetPowerAsync().
+     */
+    MU_Modem_Error PrepareTx(uint8_t peer, MU_Modem_Priority priority = MU_Modem_Priority::NormalTx);
+
+    /**
+     * @brief Returns the recommended frame size towards a peer.
+     * @param peer Peer ID.
+     * @return Payload length in bytes (maxFrameLen for unknown peers), at most what the driver's framing leaves.
+     */
+    uint8_t GetFrameLen(uint8_t peer) const;
+
+    /**
+     * @brief Gets the link state of a peer.
+     * @param peer Peer ID.
+     * @param pInfo Pointer to store the state.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pInfo is null or the peer is unknown.
+     */
+    MU_Modem_Error GetPeerInfo(uint8_t peer, MU_LinkAdapter_PeerInfo *pInfo) const;
+
+    /**
+     * @brief Returns the smoothed LBT failure rate of the channel in percent.
+     */
+    uint8_t GetLbtFailurePct() const { return (uint8_t)(((uint32_t)m_lbtFailQ8 * 100) >> 8); }
+
+    /**
+     * @brief Returns the adaptation counters.
+     */
+    const MU_LinkAdapter_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the adaptation counters.
+     */
+    void ResetStats() { m_stats = MU_LinkAdapter_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+
+private:
+    struct Peer
+    {
+        bool used;
+        bool rssiValid;
+        uint8_t id;
+        uint8_t power;
+        uint8_t frameLen;
+        uint8_t samples;     // Delivery reports since the last decision
+        int16_t rssiQ4;      // EWMA of the RSSI, dBm * 16
+        uint16_t deliveryQ8; // EWMA of the delivery ratio, 256 = 100 %
+        uint16_t avgLen;     // EWMA of the reported frame lengths
+        uint32_t lastPowerChange;
+        uint32_t lastSeen;
+    };
+
+    Peer *m_FindPeer(uint8_t peer);
+    const Peer *m_FindPeer(uint8_t peer) const;
+    Peer &m_GetPeer(uint8_t peer);
+    void m_Evaluate(Peer &peer);
+    uint8_t m_OptimalFrameLen(const Peer &peer) const;
+
+    MU_Modem *m_pModem;
+    MU_LinkAdapter_Config m_config;
+    Peer m_peers[MU_LA_MAX_PEERS];
+    uint8_t m_modemPower; // Power last applied through PrepareTx() (0 = unknown)
+    uint16_t m_lbtFailQ8; // EWMA of LBT failures per frame, 256 = 100 %
+    MU_LinkAdapter_Stats m_stats;
+};
@@ -126,25 +126,182 @@ static constexpr size_t MU_DR_SIZE_TOTAL_LEN = 6; // "*DR=XX"
 static constexpr size_t MU_DS_RSSI_TOTAL_LEN = 6; // "*DS=XX"
 static constexpr size_t MU_HEX_VAL_OFFSET = 4;    // Index of hex value in "*DR=XX" or "*DS=XX"
 
+// Supported UART rates of the modem, fastest first
+static constexpr uint32_t MU_SUPPORTED_BAUD_RATES[] = {57600, 38400, 19200, 9600, 4800, 2400, 1200};
+// Auto-baud timing: per-rate probe timeout, settle time after a host UART change, verification reads
+static constexpr uint32_t MU_BAUD_PROBE_TIMEOUT_MS = 100;
+static constexpr uint32_t MU_BAUD_SWITCH_SETTLE_MS = 20;
+static constexpr uint8_t MU_BAUD_VERIFY_ROUNDS = 3;
+
 // LBT (Listen Before Talk) check timeout after command acceptance
 static constexpr uint32_t MU_LBT_CHECK_TIMEOUT_MS = 60;
 
+// A clear carrier sense result allows retries for this long
+static constexpr uint32_t MU_CS_RESULT_VALID_MS = 20;
+
+// Extra time after a queued command's timeout before its pipeline slot is forcibly released
+static constexpr uint32_t MU_IN_FLIGHT_GRACE_MS = 500;
+
+// Duplicate suppression: probes per lookup, and the hash shift for the cache size
+static constexpr uint8_t MU_DEDUP_MAX_PROBE = 8;
+static_assert((MU_DEDUP_CACHE_SIZE & (MU_DEDUP_CACHE_SIZE - 1)) == 0, "MU_DEDUP_CACHE_SIZE must be a power of two");
+static_assert(MU_DEDUP_CACHE_SIZE >= MU_DEDUP_MAX_PROBE && MU_DEDUP_CACHE_SIZE <= 256, "MU_DEDUP_CACHE_SIZE out of range");
+
+// Longest airtime window; keeps the token bucket arithmetic within 64 bits
+static constexpr uint32_t MU_AIRTIME_MAX_WINDOW_MS = 86400000UL;
+
+// Codec frame: [MU_PROTO_CODEC][flags][body]
+// Tagged: [MU_PROTO_CODEC][flags][sender][sequence][body]
+// Encrypted: [MU_PROTO_CODEC][flags][sender][counter, 2 or 4 bytes big-endian][ciphertext][tag]
+static constexpr uint8_t MU_CODEC_HEADER_LEN = 2;
+static constexpr uint8_t MU_CODEC_FLAG_COMPRESSED = 0x01; // Body is MU_Compressor output
+static constexpr uint8_t MU_CODEC_FLAG_DICTIONARY = 0x02; // Compressed against the static dictionary
+static constexpr uint8_t MU_CODEC_FLAG_ENCRYPTED = 0x04;  // AES-CCM, whole header authenticated
+static constexpr uint8_t MU_CODEC_FLAG_FULL_SEQ = 0x08;   // Counter sent with all 32 bits instead of the low 16
+static constexpr uint8_t MU_CODEC_FLAG_LINK_TAG = 0x10;   // Unencrypted frame tagged with [sender][sequence]
+static constexpr uint8_t MU_LINK_TAG_LEN = 2;
+
+// Full counter in the first frames after SetEncryption() and then every N frames, so receivers
+// that missed the start (or rebooted) resynchronize quickly
+static constexpr uint8_t MU_AEAD_SYNC_FRAMES = 4;
+static constexpr uint8_t MU_AEAD_FULL_SEQ_INTERVAL = 64;
+// Replay window per sender in frames (bits of AeadPeer::window)
+static constexpr uint8_t MU_AEAD_REPLAY_WINDOW = 32;
+// New frames are refused beyond this counter; the margin covers frames still queued
+static constexpr uint32_t MU_AEAD_COUNTER_LIMIT = 0xFFFF0000UL;
+
+static void aeadNonce(uint8_t sender, uint32_t seq, uint8_t *pNonce)
+{
+    memset(pNonce, 0, MU_CCM_NONCE_LEN);
+    pNonce[0] = sender;
+    pNonce[1] = (uint8_t)(seq >> 24);
+    pNonce[2] = (uint8_t)(seq >> 16);
+    pNonce[3] = (uint8_t)(seq >> 8);
+    pNonce[4] = (uint8_t)seq;
+}
+
 MU_Modem_Error MU_Modem::begin(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_AsyncCallback pCallback)
+{
+    uint32_t start = millis();
+    m_InitDriver(pUart, frequencyModel, pCallback);
+    MU_Modem_Error err = m_InitModem();
+    m_lastInitTimeMs = millis() - start;
+    return err;
+}
+
+MU_Modem_Error MU_Modem::beginWarm(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, const MU_Modem_ConfigShadow &expected,
+                                   MU_Modem_AsyncCallback pCallback)
+{
+    uint32_t start = millis();
+    m_InitDriver(pUart, frequencyModel, pCallback);
+
+    // One cheap command doubles as liveness probe and re-enables RSSI reporting (lost on a modem reset)
+    MU_Modem_Error err = SetAddRssiValue();
+    if (err == MU_Modem_Error::Ok)
+        err = m_VerifyShadow(expected);
+
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_shadow = expected;
+        m_lastInitWarm = true;
+        m_nvmVolatileMask = MU_NVM_ALL; // Not reset: whatever ran before may have changed any setting volatile
+        m_lastInitTimeMs = millis() - start;
+        SM_DEBUG_PRINTF("beginWarm: Warm start in %lu ms.\n", (unsigned long)m_lastInitTimeMs);
+        return MU_Modem_Error::Ok;
+    }
+
+    SM_DEBUG_PRINTF("beginWarm: Modem state inconsistent (err=%d), falling back to reset.\n", (int)err);
+    err = m_InitModem();
+    if (err == MU_Modem_Error::Ok)
+        err = m_ApplyShadow(expected);
+    m_lastInitTimeMs = millis() - start;
+    return err;
+}
+
+MU_Modem_Error MU_Modem::beginAutoBaud(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_HostBaudCallback pSetHostBaud,
+                                       MU_Modem_AsyncCallback pCallback, uint32_t maxBaudRate)
+{
+    if (!pSetHostBaud || m_BaudRateCode(maxBaudRate) == 0)
+        return MU_Modem_Error::InvalidArg;
+
+    uint32_t start = millis();
+    m_InitDriver(pUart, frequencyModel, pCallback);
+    m_pSetHostBaud = pSetHostBaud;
+
+    // 1. Find the rate the modem currently listens on
+    MU_Modem_Error err = m_ScanBaudRate();
+    if (err != MU_Modem_Error::Ok)
+        return err;
+
+    // 2. Regular initialization. A reset reloads the NVM baud rate, which differs from the
+    // current one if a previous session changed it without saving, so scan once more on failure.
+    err = m_InitModem();
+    if (err != MU_Modem_Error::Ok)
+    {
+        SM_DEBUG_PRINTLN("beginAutoBaud: Modem lost after reset, rescanning...");
+        err = m_ScanBaudRate();
+        if (err == MU_Modem_Error::Ok)
+            err = SetAddRssiValue();
+        if (err != MU_Modem_Error::Ok)
+            return err;
+    }
+
+    // 3. Upgrade to the fastest rate both sides support. The change is volatile, so a
+    // modem reset always brings the node back to a rate the scan can find.
+    for (size_t i = 0; i < sizeof(MU_SUPPORTED_BAUD_RATES) / sizeof(MU_SUPPORTED_BAUD_RATES[0]); ++i)
+    {
+        uint32_t candidate = MU_SUPPORTED_BAUD_RATES[i];
+        if (candidate > maxBaudRate || candidate <= m_baudRate)
+            continue;
+        if (m_TryBaudRate(candidate) == MU_Modem_Error::Ok)
+            break;
+    }
+
+    m_lastInitTimeMs = millis() - start;
+    SM_DEBUG_PRINTF("beginAutoBaud: Running at %lu bps.\n", (unsigned long)m_baudRate);
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::m_InitDriver(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_AsyncCallback pCallback)
 {
     initSerial(pUart);
+    m_pUart = &pUart;
     m_frequencyModel = frequencyModel;
     m_pCallback = pCallback;
-    m_asyncExpectedResponse = MU_Modem_Response::Idle;
+    memset(m_queueHead, 0, sizeof(m_queueHead));
+    memset(m_queueCount, 0, sizeof(m_queueCount));
+    memset(m_queueSkipCount, 0, sizeof(m_queueSkipCount));
+    memset(m_queueBytes, 0, sizeof(m_queueBytes));
+    memset(m_writableArmed, 0, sizeof(m_writableArmed));
+    memset(m_writableMinBytes, 0, sizeof(m_writableMinBytes));
+    ResetQueueStats();
+    m_inFlightHead = 0;
+    m_inFlightCount = 0;
+    m_verdictHead = 0;
+    m_verdictCount = 0;
+    m_csClearAt = millis() - MU_CS_RESULT_VALID_MS - 1;
     m_lbtErrorDetected = false;
     m_blockAsyncCallback = false;
     m_ResetParser();
+    ClearNeighbors();
+
+    m_pSetHostBaud = nullptr;
+    m_baudRate = 0;
+    m_shadow = MU_Modem_ConfigShadow();
+    m_lastInitWarm = false;
+    m_nvmStagedMask = 0;
+    m_nvmSnapshotMask = 0;
+    m_nvmVolatileMask = 0;
+}
 
+MU_Modem_Error MU_Modem::m_InitModem()
+{
     SM_DEBUG_PRINTLN("begin: Waiting for modem stabilization...");
-    pUart.print("\r\n");
+    m_pUart->print("\r\n");
     uint32_t clearStart = millis();
-    while (pUart.available() > 0 && millis() - clearStart < 200)
+    while (m_pUart->available() > 0 && millis() - clearStart < 200)
     {
-        pUart.read();
+        m_pUart->read();
     }
 
     SM_DEBUG_PRINTLN("begin: Resetting modem...");
@@ -180,30 +337,85 @@ MU_Modem_Error MU_Modem::begin(Stream &pUart, MU_Modem_FrequencyModel frequencyM
 
 void MU_Modem::Work()
 {
-    // Delegate strictly to the base engine's state machine
+    bool wasInWork = m_inWork;
+    m_inWork = true;
+
+    // Run the base engine's state machine first so completed commands free their pipeline slots
     SerialModemBase::update();
+    m_ProcessTxVerdicts();
+    m_DispatchQueued();
+    m_NotifyWritable();
+
+    for (MU_Modem_Layer *pLayer = m_pLayers; pLayer != nullptr; pLayer = pLayer->m_pNextLayer)
+        pLayer->OnModemWork(*this);
+
+    m_inWork = wasInWork;
 }
 
 // --- Data Transmission (Synchronous Wrapper) ---
 
 MU_Modem_Error MU_Modem::TransmitData(const uint8_t *pMsg, uint8_t len, bool useRouteRegister)
 {
+    return m_TransmitSync(pMsg, nullptr, 0, len, useRouteRegister);
+}
+
+MU_Modem_Error MU_Modem::TransmitDataV(const MU_Modem_Segment *pSegments, uint8_t numSegments, bool useRouteRegister)
+{
+    const uint8_t *pFirst;
+    uint8_t len;
+    MU_Modem_Error err = m_ScanSegments(pSegments, numSegments, &pFirst, &len);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+    return m_TransmitSync(pFirst, pSegments, numSegments, len, useRouteRegister);
+}
+
+MU_Modem_Error MU_Modem::m_TransmitSync(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                        bool useRouteRegister)
+{
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+
     m_lbtErrorDetected = false;  // Reset LBT error flag
+
+    // Don't overflow the modem's double buffer (no-op without flow control)
+    MU_Modem_Error err = m_WaitModemTxReady(2000);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+
+    err = m_CheckTxPayload(pMsg, len);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+    if (!m_HasAirtime(m_MaxWireLen(len)))
+    {
+        m_airtimeStats.rejected++;
+        return MU_Modem_Error::Busy;
+    }
+
     m_blockAsyncCallback = true; // Suppress async callbacks during sync LBT check
 
     // 1. Prepare Command Header
+    TxSeq seq;
+    m_AssignTxSeq(&seq);
+    uint8_t wireLen;
+    const uint8_t *pWire = m_PrepareTxWire(pMsg, pSegments, numSegments, len, seq, m_txWire[MU_TX_PIPELINE_DEPTH], &wireLen);
+    if (!pWire)
+    {
+        m_blockAsyncCallback = false;
+        return MU_Modem_Error::InvalidArg;
+    }
     char cmdHeader[16];
     char *p = appendStr(cmdHeader, cmdHeader, MU_TRANSMISSION_PREFIX_STRING);
-    appendHex2(cmdHeader, p, len);
+    appendHex2(cmdHeader, p, wireLen);
 
     // 2. Queue Async Command (Wait up to 2000ms for *DT response)
     const char *suffix = useRouteRegister ? MU_ROUTE_INFO_OPTION_PREFIX : nullptr;
-    MU_Modem_Error err = enqueueTxCommand(cmdHeader, pMsg, len, suffix, 2000);
+    err = enqueueTxCommand(cmdHeader, pWire, wireLen, suffix, 2000);
     if (err != MU_Modem_Error::Ok)
     {
         m_blockAsyncCallback = false;
         return err;
     }
+    m_ChargeAirtime(wireLen);
 
     // 3. Wait for *DT=XX confirmation (Synchronous wait)
     err = waitForSyncComplete(2500);
@@ -240,228 +452,1743 @@ MU_Modem_Error MU_Modem::TransmitData(const uint8_t *pMsg, uint8_t len, bool use
 
 // --- Data Transmission (Asynchronous) ---
 
-MU_Modem_Error MU_Modem::TransmitDataAsync(const uint8_t *pMsg, uint8_t len, bool useRouteRegister)
+MU_Modem_Error MU_Modem::TransmitDataAsync(const uint8_t *pMsg, uint8_t len, bool useRouteRegister, MU_Modem_Priority priority)
 {
-    m_lbtErrorDetected = false;
+    return m_TransmitAsync(pMsg, nullptr, 0, len, useRouteRegister, priority);
+}
+
+MU_Modem_Error MU_Modem::TransmitDataVAsync(const MU_Modem_Segment *pSegments, uint8_t numSegments, bool useRouteRegister,
+                                            MU_Modem_Priority priority)
+{
+    const uint8_t *pFirst;
+    uint8_t len;
+    MU_Modem_Error err = m_ScanSegments(pSegments, numSegments, &pFirst, &len);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+    return m_TransmitAsync(pFirst, pSegments, numSegments, len, useRouteRegister, priority);
+}
 
-    // Minimal safety delay to allow modem to switch states (especially for quick echo response)
-    // delay(5);
+MU_Modem_Error MU_Modem::m_TransmitAsync(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                         bool useRouteRegister, MU_Modem_Priority priority)
+{
+    m_lbtErrorDetected = false;
 
-    char cmdHeader[16];
-    char *p = appendStr(cmdHeader, cmdHeader, MU_TRANSMISSION_PREFIX_STRING);
-    appendHex2(cmdHeader, p, len);
+    // Checked here: the frame is encoded only when dispatched
+    MU_Modem_Error check = m_CheckTxPayload(pMsg, len);
+    if (check != MU_Modem_Error::Ok)
+        return check;
+
+    QueuedCommand cmd = {};
+    cmd.isTx = true;
+    cmd.priority = priority;
+    cmd.expected = MU_Modem_Response::Idle;
+    cmd.pMsg = pMsg;
+    cmd.pSegments = pSegments;
+    cmd.numSegments = numSegments;
+    cmd.len = len;
+    cmd.useRouteRegister = useRouteRegister;
+    cmd.timeoutMs = 2000;
 
     // Just queue and return. Result will be delivered via Callback (TxComplete / TxFailed)
-    const char *suffix = useRouteRegister ? MU_ROUTE_INFO_OPTION_PREFIX : nullptr;
-    return enqueueTxCommand(cmdHeader, pMsg, len, suffix, 2000);
+    MU_Modem_Error err = m_EnqueueQueued(cmd);
+    if (err == MU_Modem_Error::Ok)
+    {
+        // Hand it over right away if the pipeline has room, so back-to-back calls keep continuous transmission
+        m_DispatchQueued();
+    }
+    return err;
 }
 
-// --- Parser Implementation ---
+// --- Command Queue ---
 
-void MU_Modem::m_ResetParser()
+MU_Modem_Error MU_Modem::m_EnqueueQueued(const QueuedCommand &cmd)
 {
-    m_parserState = MU_Modem_ParserState::Start;
-    m_drMessageLen = 0;
-    m_drNumRouteNodes = 0;
-    m_drMessagePresent = false;
-}
+    uint8_t cls = static_cast<uint8_t>(cmd.priority);
+    if (cls >= MU_PRIORITY_CLASS_COUNT)
+        return MU_Modem_Error::InvalidArg;
 
-ModemParseResult MU_Modem::parse()
-{
-    while (true)
+    MU_Modem_QueueStats &stats = m_queueStats[cls];
+    uint16_t bytes = cmd.isTx ? cmd.len : 0;
+    if (m_queueCount[cls] >= MU_CMD_QUEUE_DEPTH || m_queueBytes[cls] + bytes > MU_TX_QUEUE_MAX_BYTES)
     {
-        int c_int = readByte();
-        if (c_int == -1)
-            break;
-        uint8_t c = static_cast<uint8_t>(c_int);
-
-        switch (m_parserState)
-        {
-        case MU_Modem_ParserState::Start:
-            if (c == '*')
-            {
-                _rxIndex = 0;
-                _rxBuffer[_rxIndex++] = c;
-                m_parserState = MU_Modem_ParserState::ReadCmdPrefix;
-            }
-            break;
-
-        case MU_Modem_ParserState::ReadCmdPrefix:
+        stats.rejected++;
+        // Tell the producer when it may try again instead of letting it spin
+        if (!m_writableArmed[cls])
         {
-            ModemParseResult res = m_HandleReadCmdPrefix(c);
-            if (res != ModemParseResult::Parsing)
-                return res;
+            m_writableArmed[cls] = true;
+            m_writableMinBytes[cls] = bytes;
         }
-        break;
+        return MU_Modem_Error::Busy;
+    }
 
-        case MU_Modem_ParserState::RadioDrSize:
-        {
-            ModemParseResult res = m_HandleRadioDrSize(c);
-            if (res != ModemParseResult::Parsing)
-                return res;
-        }
-        break;
+    uint8_t tail = (m_queueHead[cls] + m_queueCount[cls]) % MU_QUEUE_CAPACITY;
+    m_queue[cls][tail] = cmd;
+    m_queue[cls][tail].enqueuedAt = millis();
+    m_queue[cls][tail].notBefore = m_queue[cls][tail].enqueuedAt;
+    if (cmd.isTx)
+        m_AssignTxSeq(&m_queue[cls][tail].seq); // Only once accepted, so a rejected frame leaves no gap
+    m_queueCount[cls]++;
+    m_queueBytes[cls] += bytes;
+
+    stats.enqueued++;
+    stats.depth = m_queueCount[cls];
+    if (stats.depth > stats.maxDepth)
+        stats.maxDepth = stats.depth;
+    return MU_Modem_Error::Ok;
+}
 
-        case MU_Modem_ParserState::RadioDsRssi:
-        {
-            ModemParseResult res = m_HandleRadioDsRssi(c);
-            if (res != ModemParseResult::Parsing)
-                return res;
-        }
-        break;
+MU_Modem_Error MU_Modem::m_EnqueueSimpleAsync(const char *cmd, MU_Modem_Priority priority, MU_Modem_Response expected, uint32_t timeoutMs)
+{
+    QueuedCommand qc = {};
+    qc.isTx = false;
+    qc.priority = priority;
+    qc.expected = expected;
+    appendStr(qc.cmd, qc.cmd, cmd);
+    qc.timeoutMs = timeoutMs;
+
+    MU_Modem_Error err = m_EnqueueQueued(qc);
+    if (err == MU_Modem_Error::Ok)
+        m_DispatchQueued();
+    return err;
+}
 
-        case MU_Modem_ParserState::RadioDrPayload:
-        {
-            ModemParseResult res = m_HandleRadioDrPayload(c);
-            if (res != ModemParseResult::Parsing)
-                return res;
-        }
-        break;
+bool MU_Modem::m_IsQueueHeadDue(uint8_t cls, uint32_t now) const
+{
+    if (m_queueCount[cls] == 0)
+        return false;
+    // Signed difference keeps the comparison valid across millis() wrap-around
+    return static_cast<int32_t>(now - m_queue[cls][m_queueHead[cls]].notBefore) >= 0;
+}
 
-        case MU_Modem_ParserState::ReadOptionUntilLF:
+int8_t MU_Modem::m_SelectQueueClass() const
+{
+    uint32_t now = millis();
+
+    // Starvation protection: a class passed over too often is served first
+    int8_t starved = -1;
+    for (uint8_t cls = 0; cls < MU_PRIORITY_CLASS_COUNT; ++cls)
+    {
+        if (m_IsQueueHeadDue(cls, now) && m_queueSkipCount[cls] >= MU_QUEUE_STARVATION_LIMIT)
         {
-            ModemParseResult res = m_HandleReadOptionUntilLF(c);
-            if (res != ModemParseResult::Parsing)
-                return res;
+            if (starved < 0 || m_queueSkipCount[cls] > m_queueSkipCount[starved])
+                starved = cls;
         }
-        break;
+    }
+    if (starved >= 0)
+        return starved;
 
-        default:
-            m_ResetParser();
-            return ModemParseResult::Garbage;
-        }
+    for (uint8_t cls = 0; cls < MU_PRIORITY_CLASS_COUNT; ++cls)
+    {
+        if (m_IsQueueHeadDue(cls, now))
+            return cls;
     }
-    return ModemParseResult::Parsing;
+    return -1;
 }
 
-ModemParseResult MU_Modem::m_HandleReadCmdPrefix(uint8_t c)
+void MU_Modem::m_DispatchQueued()
 {
-    if (_rxIndex < RX_BUFFER_SIZE)
-        _rxBuffer[_rxIndex++] = c;
+    // Safety net: never let a lost completion block the pipeline forever
+    m_ExpireInFlight();
 
-    // Check for *DR=, *DS= or *DC= (Data Reception)
-    if (_rxIndex == MU_DR_PREFIX_LEN)
+    // A synchronous command is waiting for the pipeline to drain
+    if (m_syncDraining)
+        return;
+
+    while (m_inFlightCount < MU_TX_PIPELINE_DEPTH)
     {
-        if (strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DR, MU_DR_PREFIX_LEN) == 0)
+        int8_t sel = m_SelectQueueClass();
+        if (sel < 0)
+            return;
+        uint8_t cls = static_cast<uint8_t>(sel);
+        QueuedCommand &cmd = m_queue[cls][m_queueHead[cls]];
+
+        // Only data transmissions are pipelined behind each other.
+        // Anything else waits for an idle modem so an urgent frame never queues up behind a long scan.
+        if (m_inFlightCount > 0)
         {
-            m_parserState = MU_Modem_ParserState::RadioDrSize;
-            return ModemParseResult::Parsing;
+            const QueuedCommand &last = m_inFlight[(m_inFlightHead + m_inFlightCount - 1) % MU_TX_PIPELINE_DEPTH];
+            if (!cmd.isTx || !last.isTx)
+                return;
         }
-        if (strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DS, MU_DS_PREFIX_LEN) == 0 ||
-            strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DC, MU_DS_PREFIX_LEN) == 0)
+
+        // Don't feed the modem while its transmit double buffer is full
+        if (cmd.isTx && !m_IsModemTxReady())
         {
-            m_parserState = MU_Modem_ParserState::RadioDsRssi;
-            return ModemParseResult::Parsing;
+            m_flowStats.txHolds++;
+            return;
         }
-    }
 
-    // Check for CR/LF (End of standard command response)
-    if (c == '\n')
-    {
-        if (_rxIndex > 0)
+        // Keep within the airtime budget: the frame waits in its queue until enough has accrued
+        if (cmd.isTx && !m_HasAirtime(m_MaxWireLen(cmd.len)))
         {
-            _rxIndex--;
-            _rxBuffer[_rxIndex] = 0;
+            m_airtimeStats.holds++;
+            return;
         }
-        if (_rxIndex > 0 && _rxBuffer[_rxIndex - 1] == '\r')
+
+        // Layers may restrict when frames go on air (e.g. slotted access)
+        if (cmd.isTx && !m_IsTxGateOpen(m_MaxWireLen(cmd.len)))
+            return;
+
+        // Every accepted frame needs a place to await its LBT result: hold back while they are all taken
+        if (cmd.isTx && m_verdictCount + m_InFlightTxCount() >= MU_TX_VERDICT_DEPTH)
+            return;
+
+        // Optionally confirm the channel is free before resending a frame that failed LBT
+        if (cmd.isTx && cmd.attempts > 0 && m_retryPolicy.carrierSenseCheck && millis() - m_csClearAt > MU_CS_RESULT_VALID_MS)
         {
-            _rxIndex--;
-            _rxBuffer[_rxIndex] = 0;
+            if (m_inFlightCount == 0)
+                m_DispatchCarrierSense();
+            return;
         }
 
-        m_parserState = MU_Modem_ParserState::Start;
-
-        // Check for LBT Error (*IR=01)
-        if (strncmp((char *)_rxBuffer, MU_LBT_ERROR_RESPONSE, 6) == 0)
+        MU_Modem_Error err;
+        uint8_t wireLen = 0;
+        MU_Modem_CompressionStats compressStats = m_compressStats;
+        MU_Modem_SecurityStats securityStats = m_securityStats;
+        if (cmd.isTx)
         {
-            m_lbtErrorDetected = true;
-            if (m_pCallback)
+            // The wire image lives in the buffer of the in-flight slot this frame is about to take
+            uint8_t slot = (m_inFlightHead + m_inFlightCount) % MU_TX_PIPELINE_DEPTH;
+            if (cmd.seq.epoch != m_codecEpoch)
+                m_AssignTxSeq(&cmd.seq); // Framing changed while it was queued
+            const uint8_t *pWire = m_PrepareTxWire(cmd.pMsg, cmd.pSegments, cmd.numSegments, cmd.len, cmd.seq, m_txWire[slot], &wireLen);
+            if (!pWire)
             {
-                m_pCallback(MU_Modem_Event(MU_Modem_Error::FailLbt, MU_Modem_Response::TxFailed));
+                // Does not fit a frame once encoded: fail it, as TransmitData() does
+                QueuedCommand failed = cmd;
+                m_DropQueueHead(cls);
+                MU_Modem_Event ev(MU_Modem_Error::InvalidArg, MU_Modem_Response::TxFailed);
+                ev.pPayload = failed.pMsg;
+                ev.payloadLen = failed.len;
+                m_EmitEvent(ev);
+                continue;
             }
-            return ModemParseResult::FinishedCmdResponse;
+            char cmdHeader[16];
+            char *p = appendStr(cmdHeader, cmdHeader, MU_TRANSMISSION_PREFIX_STRING);
+            appendHex2(cmdHeader, p, wireLen);
+            const char *suffix = cmd.useRouteRegister ? MU_ROUTE_INFO_OPTION_PREFIX : nullptr;
+            err = enqueueTxCommand(cmdHeader, pWire, wireLen, suffix, cmd.timeoutMs);
+        }
+        else
+        {
+            err = enqueueCommand(cmd.cmd, CommandType::Simple, cmd.timeoutMs);
         }
 
-        return ModemParseResult::FinishedCmdResponse;
-    }
-    return ModemParseResult::Parsing;
-}
-
-ModemParseResult MU_Modem::m_HandleRadioDrSize(uint8_t c)
-{
-    if (_rxIndex < RX_BUFFER_SIZE)
-        _rxBuffer[_rxIndex++] = c;
-    if (_rxIndex == MU_DR_SIZE_TOTAL_LEN)
-    {
-        uint32_t len;
-        if (parseHex(&_rxBuffer[MU_HEX_VAL_OFFSET], 2, &len))
+        if (err != MU_Modem_Error::Ok)
         {
-            m_drMessageLen = (uint8_t)len;
-            m_parserState = MU_Modem_ParserState::RadioDrPayload;
-            _rxIndex = 0;
-            return ModemParseResult::Parsing;
+            // Base queue is occupied (e.g. by a synchronous command). Retry on the next Work(),
+            // which encodes the frame again with the same sequence number: count it only once.
+            m_compressStats = compressStats;
+            m_securityStats = securityStats;
+            return;
         }
-        else
+
+        if (cmd.isTx)
+            m_ChargeAirtime(wireLen);
+
+        MU_Modem_QueueStats &stats = m_queueStats[cls];
+        uint32_t waited = millis() - cmd.enqueuedAt;
+        if (waited > stats.maxWaitMs)
+            stats.maxWaitMs = waited;
+        stats.dispatched++;
+
+        cmd.dispatchedAt = millis();
+        cmd.startedAt = cmd.dispatchedAt; // Restarted when it reaches the head of a busy pipeline
+        cmd.wireLen = wireLen;
+        if (cmd.isTx)
+            cmd.attempts++;
+        m_inFlight[(m_inFlightHead + m_inFlightCount) % MU_TX_PIPELINE_DEPTH] = cmd;
+        m_inFlightCount++;
+
+        m_queueHead[cls] = (m_queueHead[cls] + 1) % MU_QUEUE_CAPACITY;
+        m_queueCount[cls]--;
+        if (cmd.isTx)
+            m_queueBytes[cls] -= cmd.len;
+        stats.depth = m_queueCount[cls];
+
+        // Age every class that was passed over
+        m_queueSkipCount[cls] = 0;
+        for (uint8_t other = 0; other < MU_PRIORITY_CLASS_COUNT; ++other)
         {
-            m_parserState = MU_Modem_ParserState::Start;
-            return ModemParseResult::Garbage;
+            if (other != cls && m_queueCount[other] > 0 && m_queueSkipCount[other] < 0xFF)
+                m_queueSkipCount[other]++;
         }
     }
-    return ModemParseResult::Parsing;
 }
 
-ModemParseResult MU_Modem::m_HandleRadioDsRssi(uint8_t c)
+bool MU_Modem::m_WaitAsyncIdle()
 {
-    if (_rxIndex < RX_BUFFER_SIZE)
-        _rxBuffer[_rxIndex++] = c;
-    if (_rxIndex == MU_DS_RSSI_TOTAL_LEN)
+    // A synchronous completion must never be taken for one of the queued commands. Let the commands
+    // already handed to the modem finish, holding back the queues so attached layers cannot keep it busy.
+    if (m_inFlightCount == 0)
+        return true;
+    if (m_syncDraining || m_inWork)
+        return false; // Called from a callback or layer: Work() must not be re-entered
+
+    m_syncDraining = true;
+    uint32_t start = millis();
+    while (m_inFlightCount > 0 && millis() - start < MU_SYNC_DRAIN_TIMEOUT_MS)
     {
-        uint32_t rssiVal;
-        if (parseHex(&_rxBuffer[MU_HEX_VAL_OFFSET], 2, &rssiVal))
-        {
-            m_lastRxRSSI = -static_cast<int16_t>(rssiVal);
-            // After RSSI, the format is the same as *DR (size, payload, etc.)
-            // So, transition to the size-parsing state.
-            m_parserState = MU_Modem_ParserState::RadioDrSize;
-            _rxIndex = MU_DR_PREFIX_LEN; // Pretend we just saw "*DR=" to reuse the logic
-            return ModemParseResult::Parsing;
-        }
-        else
-        {
-            m_parserState = MU_Modem_ParserState::Start;
-            return ModemParseResult::Garbage;
-        }
+        Work();
+        delay(1);
     }
-    return ModemParseResult::Parsing;
+    m_syncDraining = false;
+    return m_inFlightCount == 0;
 }
 
-ModemParseResult MU_Modem::m_HandleRadioDrPayload(uint8_t c)
+void MU_Modem::m_DropQueueHead(uint8_t cls)
+{
+    const QueuedCommand &head = m_queue[cls][m_queueHead[cls]];
+    if (head.isTx)
+        m_queueBytes[cls] -= head.len;
+    m_queueHead[cls] = (m_queueHead[cls] + 1) % MU_QUEUE_CAPACITY;
+    m_queueCount[cls]--;
+    m_queueStats[cls].depth = m_queueCount[cls];
+}
+
+bool MU_Modem::m_PopInFlight(QueuedCommand *pCmd)
 {
-    if (_rxIndex < m_drMessageLen)
+    // Commands complete in the order they were handed to the base queue.
+    // A completion while nothing is in flight belongs to a synchronous command.
+    if (m_inFlightCount == 0)
+        return false;
+
+    if (pCmd)
+        *pCmd = m_inFlight[m_inFlightHead];
+    m_inFlightHead = (m_inFlightHead + 1) % MU_TX_PIPELINE_DEPTH;
+    m_inFlightCount--;
+
+    // The base works through its queue in order, so the next command only starts now
+    if (m_inFlightCount > 0)
+        m_inFlight[m_inFlightHead].startedAt = millis();
+    return true;
+}
+
+void MU_Modem::m_ExpireInFlight()
+{
+    if (m_inFlightCount == 0)
+        return;
+    const QueuedCommand &head = m_inFlight[m_inFlightHead];
+    if (millis() - head.startedAt <= head.timeoutMs + MU_IN_FLIGHT_GRACE_MS)
+        return;
+
+    SM_DEBUG_PRINTLN("Dispatch: in-flight command expired, releasing slot.");
+    QueuedCommand expired;
+    m_PopInFlight(&expired);
+    if (expired.isCarrierSense)
+        return; // Internal pre-check: the retry scheduler simply asks again
+
+    // Report it like any other failure so the owner of the buffer (and layers counting their frames) can move on
+    MU_Modem_Event ev(MU_Modem_Error::Timeout, expired.isTx ? MU_Modem_Response::TxFailed : expired.expected);
+    if (expired.isTx)
     {
-        if (_rxIndex < RX_BUFFER_SIZE)
-            _rxBuffer[_rxIndex] = c;
-        _rxIndex++;
+        ev.pPayload = expired.pMsg;
+        ev.payloadLen = expired.len;
+        ev.wireLen = expired.wireLen;
     }
-
-    if (_rxIndex == m_drMessageLen)
+    else if (expired.expected == MU_Modem_Response::Idle)
     {
-        m_parserState = MU_Modem_ParserState::ReadOptionUntilLF;
+        ev.type = MU_Modem_Response::GenericResponse;
     }
-    return ModemParseResult::Parsing;
+    m_EmitEvent(ev);
 }
 
-ModemParseResult MU_Modem::m_HandleReadOptionUntilLF(uint8_t c)
-{
-    if (_rxIndex < RX_BUFFER_SIZE)
-        _rxBuffer[_rxIndex++] = c;
+// --- LBT Retransmission ---
+
+uint8_t MU_Modem::m_InFlightTxCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < m_inFlightCount; ++i)
+    {
+        if (m_inFlight[(m_inFlightHead + i) % MU_TX_PIPELINE_DEPTH].isTx)
+            count++;
+    }
+    return count;
+}
+
+void MU_Modem::m_DispatchCarrierSense()
+{
+    QueuedCommand cs = {};
+    cs.isTx = false;
+    cs.isCarrierSense = true;
+    cs.expected = MU_Modem_Response::Idle;
+    char *p = appendStr(cs.cmd, cs.cmd, MU_CMD_CHANNEL_STATUS);
+    appendStr(cs.cmd, p, "\r\n");
+    cs.timeoutMs = 500;
+
+    if (enqueueCommand(cs.cmd, CommandType::Simple, cs.timeoutMs) != MU_Modem_Error::Ok)
+        return;
+    cs.dispatchedAt = millis();
+    cs.startedAt = cs.dispatchedAt;
+    m_inFlight[(m_inFlightHead + m_inFlightCount) % MU_TX_PIPELINE_DEPTH] = cs;
+    m_inFlightCount++;
+}
+
+void MU_Modem::m_OnCarrierSenseResult(const uint8_t *rxBuf)
+{
+    if (strncmp((const char *)rxBuf, MU_CHANNEL_STATUS_OK_RESPONSE, MU_CHANNEL_STATUS_RESPONSE_LEN) == 0)
+    {
+        m_csClearAt = millis();
+        return;
+    }
+
+    // Channel still busy (or no valid answer): every waiting retry backs off once more.
+    // Nothing went on air, so the attempt budget is left for real LBT failures.
+    m_retryStats.carrierBusy++;
+    for (uint8_t cls = 0; cls < MU_PRIORITY_CLASS_COUNT; ++cls)
+    {
+        if (m_queueCount[cls] == 0)
+            continue;
+        QueuedCommand &head = m_queue[cls][m_queueHead[cls]];
+        if (!head.isTx || head.attempts == 0)
+            continue;
+        head.notBefore = millis() + m_RetryBackoffMs(head.attempts);
+    }
+}
+
+uint32_t MU_Modem::m_RetryBackoffMs(uint8_t attempts) const
+{
+    // Exponential backoff with random jitter in [backoff/2, backoff]
+    uint32_t backoff = m_retryPolicy.baseBackoffMs;
+    for (uint8_t i = 1; i < attempts && backoff < m_retryPolicy.maxBackoffMs; ++i)
+        backoff <<= 1;
+    if (backoff > m_retryPolicy.maxBackoffMs)
+        backoff = m_retryPolicy.maxBackoffMs;
+    return random(backoff / 2, backoff + 1);
+}
+
+void MU_Modem::m_OnTxLbtFailure(const QueuedCommand &cmd)
+{
+    m_retryStats.lbtFailures++;
+    if (cmd.attempts >= m_retryPolicy.maxAttempts)
+    {
+        m_FinishTx(cmd, false);
+        return;
+    }
+
+    // Requeue at the head of its class so it goes before frames not yet dispatched. A frame pipelined
+    // behind it may already be on air, though, so retried frames can arrive out of order. The reserve
+    // slots beyond MU_CMD_QUEUE_DEPTH guarantee room for every frame that was in flight.
+    uint8_t cls = static_cast<uint8_t>(cmd.priority);
+    if (m_queueCount[cls] >= MU_QUEUE_CAPACITY)
+    {
+        m_FinishTx(cmd, false);
+        return;
+    }
+    m_queueHead[cls] = (m_queueHead[cls] + MU_QUEUE_CAPACITY - 1) % MU_QUEUE_CAPACITY;
+    QueuedCommand &retry = m_queue[cls][m_queueHead[cls]];
+    retry = cmd;
+    retry.notBefore = millis() + m_RetryBackoffMs(cmd.attempts);
+    m_queueCount[cls]++;
+    m_queueBytes[cls] += cmd.len;
+    m_queueStats[cls].depth = m_queueCount[cls];
+    SM_DEBUG_PRINTF("Retry: LBT failure, attempt %u scheduled.\n", (unsigned)(cmd.attempts + 1));
+}
+
+void MU_Modem::m_FinishTx(const QueuedCommand &cmd, bool delivered)
+{
+    if (delivered)
+    {
+        m_retryStats.framesDelivered++;
+        m_retryStats.attemptsDelivered += cmd.attempts;
+        if (cmd.attempts > m_retryStats.maxAttempts)
+            m_retryStats.maxAttempts = cmd.attempts;
+    }
+    else
+    {
+        m_retryStats.framesDropped++;
+    }
+
+    MU_Modem_Event ev(delivered ? MU_Modem_Error::Ok : MU_Modem_Error::FailLbt,
+                      delivered ? MU_Modem_Response::TxComplete : MU_Modem_Response::TxFailed);
+    ev.pPayload = cmd.pMsg;
+    ev.payloadLen = cmd.len;
+    ev.timestampUs = cmd.respUs;
+    ev.wireLen = cmd.wireLen;
+    m_EmitEvent(ev);
+}
+
+bool MU_Modem::m_OnLbtError()
+{
+    // Returns true if the error was attributed to a frame under retry control
+    if (m_verdictCount > 0)
+    {
+        // Oldest accepted frame still inside its LBT window
+        QueuedCommand cmd = m_txVerdict[m_verdictHead];
+        m_verdictHead = (m_verdictHead + 1) % MU_TX_VERDICT_DEPTH;
+        m_verdictCount--;
+        m_OnTxLbtFailure(cmd);
+        return true;
+    }
+    if (m_retryPolicy.maxAttempts > 1 && m_inFlightCount > 0 && m_inFlight[m_inFlightHead].isTx)
+    {
+        // *IR=01 came in place of the *DT response; handled when the command completes
+        m_inFlight[m_inFlightHead].lbtFailed = true;
+        return true;
+    }
+    return false;
+}
+
+void MU_Modem::m_ProcessTxVerdicts()
+{
+    // Frames whose LBT window passed without *IR=01 were sent
+    while (m_verdictCount > 0 && millis() - m_txVerdict[m_verdictHead].dispatchedAt >= MU_LBT_CHECK_TIMEOUT_MS)
+    {
+        QueuedCommand cmd = m_txVerdict[m_verdictHead];
+        m_verdictHead = (m_verdictHead + 1) % MU_TX_VERDICT_DEPTH;
+        m_verdictCount--;
+        m_FinishTx(cmd, true);
+    }
+}
+
+void MU_Modem::m_AwaitTxVerdict(const QueuedCommand &cmd)
+{
+    // m_DispatchQueued() keeps a slot free for every frame in flight
+    QueuedCommand &slot = m_txVerdict[(m_verdictHead + m_verdictCount) % MU_TX_VERDICT_DEPTH];
+    slot = cmd;
+    slot.dispatchedAt = millis(); // Start of the LBT window
+    m_verdictCount++;
+}
+
+MU_Modem_Error MU_Modem::SetTxRetryPolicy(const MU_Modem_RetryPolicy &policy)
+{
+    if (policy.maxAttempts == 0 || policy.baseBackoffMs == 0 || policy.maxBackoffMs < policy.baseBackoffMs)
+        return MU_Modem_Error::InvalidArg;
+    m_retryPolicy = policy;
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::GetTxRetryStats(MU_Modem_RetryStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_retryStats;
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::ResetTxRetryStats()
+{
+    m_retryStats = MU_Modem_RetryStats();
+}
+
+// --- Link Quality Table ---
+
+void MU_Modem::SetLinkTag(bool enable, uint8_t nodeId)
+{
+    m_linkTagEnabled = enable && MU_ENABLE_PAYLOAD_CODEC;
+    m_linkTagNodeId = nodeId;
+    m_codecEpoch++;
+}
+
+const MU_Modem_Neighbor *MU_Modem::GetNeighbor(uint8_t id) const
+{
+    uint8_t entry = m_FindNeighbor(id);
+    return entry ? &m_neighbors[entry - 1] : nullptr;
+}
+
+uint8_t MU_Modem::m_FindNeighbor(uint8_t id) const
+{
+    // Returns the table entry + 1, or 0 if the sender is not in the table
+#if MU_NEIGHBOR_DIRECT_INDEX
+    return m_neighborIndex[id];
+#else
+    for (uint8_t i = 0; i < m_neighborCount; i++)
+    {
+        if (m_neighbors[i].id == id)
+            return i + 1;
+    }
+    return 0;
+#endif
+}
+
+const MU_Modem_Neighbor *MU_Modem::GetNeighborAt(uint8_t index) const
+{
+    return (index < m_neighborCount) ? &m_neighbors[index] : nullptr;
+}
+
+void MU_Modem::ClearNeighbors()
+{
+#if MU_NEIGHBOR_DIRECT_INDEX
+    memset(m_neighborIndex, 0, sizeof(m_neighborIndex));
+#endif
+    m_neighborCount = 0;
+}
+
+void MU_Modem::m_UpdateNeighbor(uint8_t id, int16_t rssi, bool hasSeq, uint8_t seq)
+{
+    uint32_t now = millis();
+    uint8_t entry = m_FindNeighbor(id);
+    if (entry == 0)
+    {
+        // New sender: append, or replace the one silent for the longest time
+        uint8_t slot = m_neighborCount;
+        if (slot < MU_NEIGHBOR_TABLE_SIZE)
+        {
+            m_neighborCount++;
+        }
+        else
+        {
+            slot = 0;
+            for (uint8_t i = 1; i < MU_NEIGHBOR_TABLE_SIZE; i++)
+            {
+                if (now - m_neighbors[i].lastSeenMs > now - m_neighbors[slot].lastSeenMs)
+                    slot = i;
+            }
+#if MU_NEIGHBOR_DIRECT_INDEX
+            m_neighborIndex[m_neighbors[slot].id] = 0;
+#endif
+        }
+
+        MU_Modem_Neighbor &n = m_neighbors[slot];
+        n = MU_Modem_Neighbor();
+        n.id = id;
+        n.rssiDbm = rssi;
+        NeighborState &st = m_neighborState[slot];
+        st.rssiQ4 = (int16_t)(rssi * 16);
+        st.lossQ8 = 0;
+        st.seqValid = false;
+        entry = slot + 1;
+#if MU_NEIGHBOR_DIRECT_INDEX
+        m_neighborIndex[id] = entry;
+#endif
+    }
+
+    MU_Modem_Neighbor &n = m_neighbors[entry - 1];
+    NeighborState &st = m_neighborState[entry - 1];
+    st.rssiQ4 += (int16_t)(((int16_t)(rssi * 16) - st.rssiQ4) / 8);
+    n.rssiDbm = (int16_t)(st.rssiQ4 / 16);
+    n.packets++;
+    n.lastSeenMs = now;
+
+    if (hasSeq)
+    {
+        // A forward jump of less than half the sequence space is a gap; anything else a duplicate or reordering
+        uint8_t gap = (uint8_t)(seq - st.lastSeq - 1);
+        if (st.seqValid && gap < 0x80)
+        {
+            n.lost += gap;
+            // One loss sample per expected frame: the gap's misses followed by this arrival
+            for (uint8_t i = 0; i < gap && i < 16; i++)
+                st.lossQ8 += (256 - st.lossQ8) / 8;
+            st.lossQ8 -= st.lossQ8 / 8;
+            n.lossPct = (uint8_t)(((uint32_t)st.lossQ8 * 100) >> 8);
+        }
+        else if (st.seqValid && seq != st.lastSeq && (uint8_t)(st.lastSeq - seq) < 16 && n.lost > 0)
+        {
+            // Late rather than lost: sequence numbers are taken when frames are queued, so a frame
+            // of a lower priority class may go on air after a later one
+            n.lost--;
+            st.lossQ8 -= st.lossQ8 / 8;
+            n.lossPct = (uint8_t)(((uint32_t)st.lossQ8 * 100) >> 8);
+        }
+        if (!st.seqValid || gap < 0x80)
+            st.lastSeq = seq;
+        st.seqValid = true;
+    }
+}
+
+// --- Duplicate Suppression ---
+
+void MU_Modem::SetDuplicateFilter(bool enable, uint32_t expiryMs)
+{
+    m_dedupEnabled = enable;
+    m_dedupExpiryMs = expiryMs;
+    memset(m_dedupCache, 0, sizeof(m_dedupCache));
+}
+
+MU_Modem_Error MU_Modem::GetDedupStats(MU_Modem_DedupStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_dedupStats;
+    return MU_Modem_Error::Ok;
+}
+
+// --- Receive Filters ---
+
+MU_Modem_Error MU_Modem::SetRxFilters(const MU_Modem_RxFilter *pFilters, uint8_t count, MU_Modem_RxFilterAction defaultAction)
+{
+    if (count > MU_RX_FILTER_COUNT || (count > 0 && !pFilters))
+        return MU_Modem_Error::InvalidArg;
+    uint8_t prefixMax = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const MU_Modem_RxFilter &f = pFilters[i];
+        if (f.prefixLen > MU_RX_FILTER_PREFIX_MAX || f.minLen > f.maxLen)
+            return MU_Modem_Error::InvalidArg;
+        if (f.prefixLen > prefixMax)
+            prefixMax = f.prefixLen;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+        m_rxFilters[i] = pFilters[i];
+    m_rxFilterCount = count;
+    m_rxFilterPrefixMax = prefixMax;
+    m_rxFilterDefault = defaultAction;
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::GetRxFilterStats(MU_Modem_RxFilterStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_rxFilterStats;
+    return MU_Modem_Error::Ok;
+}
+
+bool MU_Modem::m_AcceptRxFrame()
+{
+    if (m_rxFilterCount == 0)
+        return true;
+
+    // _rxBuffer holds the first min(m_rxFilterPrefixMax, length) payload bytes
+    MU_Modem_RxFilterAction action = m_rxFilterDefault;
+    uint8_t i = 0;
+    for (; i < m_rxFilterCount; i++)
+    {
+        const MU_Modem_RxFilter &f = m_rxFilters[i];
+        if (m_drMessageLen < f.minLen || m_drMessageLen > f.maxLen)
+            continue;
+        if (m_rxHasRssi && m_lastRxRSSI < f.minRssiDbm)
+            continue;
+        if (f.prefixLen > m_drMessageLen || memcmp(_rxBuffer, f.prefix, f.prefixLen) != 0)
+            continue;
+        action = f.action;
+        break;
+    }
+    if (i < m_rxFilterCount)
+        m_rxFilterStats.hits[i]++;
+    else
+        m_rxFilterStats.defaultHits++;
+
+    if (action == MU_Modem_RxFilterAction::Drop)
+    {
+        m_rxFilterStats.dropped++;
+        return false;
+    }
+    return true;
+}
+
+void MU_Modem::m_DecideRxFrame()
+{
+    m_rxUndecided = false;
+    if (!m_AcceptRxFrame())
+    {
+        m_rxDropping = true;
+        return;
+    }
+    // Encoded frames must be decoded (and, encrypted, authenticated) as a whole: never streamed
+    bool codec = m_compressEnabled || m_aeadEnabled || m_linkTagEnabled;
+    if (m_pRxSink && !codec && m_drMessageLen > 0 && m_pRxSink->OnRxBegin(*this, m_drMessageLen, m_lastRxRSSI))
+    {
+        // Bytes read for the filters are already in _rxBuffer
+        m_rxStreaming = true;
+        if (_rxIndex > 0)
+            m_pRxSink->OnRxData(*this, _rxBuffer, (uint8_t)_rxIndex);
+    }
+}
+
+bool MU_Modem::m_IsDuplicate()
+{
+    // Needs the link tag's sequence number. Encrypted frames are deduplicated by the replay window.
+    if (!m_rxHasSender || m_aeadEnabled)
+        return false;
+
+    // Key: [1][0][originator][tag sender][sequence]; bit 31 keeps it non-zero
+    uint8_t origin = (m_drNumRouteNodes > 0) ? m_drRouteInfo[0] : m_rxSender;
+    uint32_t key = 0x80000000UL | ((uint32_t)origin << 16) | ((uint32_t)m_rxSender << 8) | m_rxSeq;
+
+    uint32_t now = millis();
+    uint8_t mask = MU_DEDUP_CACHE_SIZE - 1;
+    uint8_t slot = (uint8_t)((key * 2654435761UL) >> 24) & mask;
+    int16_t freeSlot = -1;
+    uint8_t oldest = slot;
+    for (uint8_t probe = 0; probe < MU_DEDUP_MAX_PROBE; probe++, slot = (slot + 1) & mask)
+    {
+        DedupEntry &e = m_dedupCache[slot];
+        bool live = e.key != 0 && now - e.seenAt < m_dedupExpiryMs;
+        if (live && e.key == key)
+        {
+            m_dedupStats.hits++;
+            return true;
+        }
+        if (!live && freeSlot < 0)
+            freeSlot = slot;
+        if (e.key == 0)
+            break; // Never used: the key cannot be further along
+        if (now - e.seenAt > now - m_dedupCache[oldest].seenAt)
+            oldest = slot;
+    }
+
+    // Expired entries are reused rather than emptied, so probe runs stay intact
+    if (freeSlot < 0)
+    {
+        freeSlot = oldest;
+        m_dedupStats.evictions++;
+    }
+    m_dedupCache[freeSlot].key = key;
+    m_dedupCache[freeSlot].seenAt = now;
+    m_dedupStats.misses++;
+    return false;
+}
+
+// --- Airtime Budget ---
+
+MU_Modem_Error MU_Modem::SetAirtimePolicy(const MU_Modem_AirtimePolicy &policy)
+{
+    if (policy.limitMs != 0)
+    {
+        if (policy.windowMs == 0 || policy.windowMs > MU_AIRTIME_MAX_WINDOW_MS || policy.limitMs > policy.windowMs || policy.burstMs >= policy.limitMs ||
+            policy.burstMs > 0xFFFFFFFFUL / 1000 || (uint64_t)policy.burstMs * 1000 < GetFrameAirtimeUs(MU_MAX_PAYLOAD_LEN))
+            return MU_Modem_Error::InvalidArg;
+    }
+    m_airtimePolicy = policy;
+    m_airtimeTokensUs = policy.burstMs * 1000;
+    m_airtimeRemainder = 0;
+    m_airtimeRefillAt = millis();
+    return MU_Modem_Error::Ok;
+}
+
+uint32_t MU_Modem::GetFrameAirtimeUs(uint8_t len) const
+{
+    uint32_t byteUs = (m_frequencyModel == MU_Modem_FrequencyModel::MHz_1216) ? MU_AIRTIME_BYTE_US_1216 : MU_AIRTIME_BYTE_US_429;
+    return ((uint32_t)len + MU_AIRTIME_OVERHEAD_BYTES) * byteUs;
+}
+
+MU_Modem_Error MU_Modem::EstimateAirTime(const MU_Modem_Event &event, uint32_t *pStartUs, uint32_t *pEndUs) const
+{
+    if (event.timestampUs == 0)
+        return MU_Modem_Error::InvalidArg;
+
+    uint32_t airUs = GetFrameAirtimeUs(event.wireLen);
+    uint32_t endUs;
+    if (event.type == MU_Modem_Response::DataReceived)
+    {
+        // The '*' itself took one character time on the UART (10 bits) before the parser saw it
+        uint32_t baud = m_baudRate ? m_baudRate : MU_DEFAULT_BAUDRATE;
+        endUs = event.timestampUs - 10000000UL / baud;
+    }
+    else if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        endUs = event.timestampUs + MU_TX_START_DELAY_US + airUs;
+    }
+    else
+    {
+        return MU_Modem_Error::InvalidArg;
+    }
+
+    if (pStartUs)
+        *pStartUs = endUs - airUs;
+    if (pEndUs)
+        *pEndUs = endUs;
+    return MU_Modem_Error::Ok;
+}
+
+uint32_t MU_Modem::GetAirtimeAvailableUs()
+{
+    if (m_airtimePolicy.limitMs == 0)
+        return 0xFFFFFFFFUL;
+    m_RefillAirtime();
+    return m_airtimeTokensUs;
+}
+
+uint32_t MU_Modem::GetAirtimeWaitMs(uint8_t len)
+{
+    if (m_airtimePolicy.limitMs == 0)
+        return 0;
+    m_RefillAirtime();
+    uint32_t needUs = GetFrameAirtimeUs(m_MaxWireLen(len));
+    if (m_airtimeTokensUs >= needUs)
+        return 0;
+
+    // Refill rate is (limitMs - burstMs) * 1000 us per windowMs
+    uint64_t deficit = (uint64_t)(needUs - m_airtimeTokensUs) * m_airtimePolicy.windowMs;
+    uint64_t rate = (uint64_t)(m_airtimePolicy.limitMs - m_airtimePolicy.burstMs) * 1000;
+    return (uint32_t)((deficit - m_airtimeRemainder + rate - 1) / rate);
+}
+
+MU_Modem_Error MU_Modem::GetAirtimeStats(MU_Modem_AirtimeStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_airtimeStats;
+    pStats->airtimeMs = (uint32_t)(m_airtimeTotalUs / 1000);
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::ResetAirtimeStats()
+{
+    m_airtimeStats = MU_Modem_AirtimeStats();
+    m_airtimeTotalUs = 0;
+}
+
+uint8_t MU_Modem::m_MaxWireLen(uint8_t len) const
+{
+    // Upper bound before encoding: compression only shrinks, but codec headers and tags add bytes
+    uint16_t wireLen = len;
+    if (m_aeadEnabled)
+        wireLen += MU_AEAD_HEADER_MAX_LEN + m_aeadTagLen;
+    else if (m_linkTagEnabled)
+        wireLen += MU_CODEC_HEADER_LEN + MU_LINK_TAG_LEN;
+    else if (m_compressEnabled)
+        wireLen += MU_CODEC_HEADER_LEN;
+    return (wireLen > MU_MAX_PAYLOAD_LEN) ? MU_MAX_PAYLOAD_LEN : (uint8_t)wireLen;
+}
+
+void MU_Modem::m_RefillAirtime()
+{
+    uint32_t now = millis();
+    uint32_t elapsed = now - m_airtimeRefillAt;
+    m_airtimeRefillAt = now;
+
+    // A full window refills the bucket completely, which also keeps the product below 2^64
+    uint32_t capacityUs = m_airtimePolicy.burstMs * 1000;
+    if (elapsed >= m_airtimePolicy.windowMs)
+    {
+        m_airtimeTokensUs = capacityUs;
+        m_airtimeRemainder = 0;
+        return;
+    }
+
+    uint64_t add = (uint64_t)elapsed * (m_airtimePolicy.limitMs - m_airtimePolicy.burstMs) * 1000 + m_airtimeRemainder;
+    uint64_t tokens = m_airtimeTokensUs + add / m_airtimePolicy.windowMs;
+    m_airtimeRemainder = (uint32_t)(add % m_airtimePolicy.windowMs);
+    if (tokens >= capacityUs)
+    {
+        tokens = capacityUs;
+        m_airtimeRemainder = 0;
+    }
+    m_airtimeTokensUs = (uint32_t)tokens;
+}
+
+bool MU_Modem::m_HasAirtime(uint8_t wireLen)
+{
+    if (m_airtimePolicy.limitMs == 0)
+        return true;
+    m_RefillAirtime();
+    return m_airtimeTokensUs >= GetFrameAirtimeUs(wireLen);
+}
+
+void MU_Modem::m_ChargeAirtime(uint8_t wireLen)
+{
+    uint32_t airtimeUs = GetFrameAirtimeUs(wireLen);
+    m_airtimeTotalUs += airtimeUs;
+    m_airtimeStats.frames++;
+    if (m_airtimePolicy.limitMs == 0)
+        return;
+    m_RefillAirtime();
+    m_airtimeTokensUs = (m_airtimeTokensUs > airtimeUs) ? m_airtimeTokensUs - airtimeUs : 0;
+}
+
+// --- Payload Compression ---
+
+void MU_Modem::SetCompression(bool enable, const uint8_t *pDictionary, uint16_t dictionaryLen)
+{
+    m_compressEnabled = enable && MU_ENABLE_PAYLOAD_CODEC;
+    m_pCompressDict = pDictionary;
+    m_compressDictLen = pDictionary ? dictionaryLen : 0;
+}
+
+MU_Modem_Error MU_Modem::GetCompressionStats(MU_Modem_CompressionStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_compressStats;
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::m_CheckTxPayload(const uint8_t *pMsg, uint8_t len) const
+{
+    if (len > GetMaxPayloadLen())
+        return MU_Modem_Error::InvalidArg;
+    if (m_aeadEnabled)
+    {
+        if (m_aeadTxCounter > MU_AEAD_COUNTER_LIMIT)
+            return MU_Modem_Error::Fail; // Counter exhausted: a new key is needed
+    }
+    else if (m_compressEnabled && !m_linkTagEnabled && len > MU_MAX_PAYLOAD_LEN - MU_CODEC_HEADER_LEN &&
+             pMsg[0] == MU_PROTO_CODEC)
+    {
+        // A payload that looks like a codec frame must be wrapped, which costs two bytes
+        return MU_Modem_Error::InvalidArg;
+    }
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::m_ScanSegments(const MU_Modem_Segment *pSegments, uint8_t numSegments, const uint8_t **ppFirst, uint8_t *pLen)
+{
+    if (!MU_ENABLE_TX_GATHER || !pSegments || numSegments == 0)
+        return MU_Modem_Error::InvalidArg;
+
+    // Total length up front, so the frame is checked and the @DT header written before any byte is copied
+    uint16_t total = 0;
+    *ppFirst = nullptr;
+    for (uint8_t i = 0; i < numSegments; i++)
+    {
+        if (pSegments[i].len == 0)
+            continue;
+        if (!pSegments[i].pData)
+            return MU_Modem_Error::InvalidArg;
+        if (!*ppFirst)
+            *ppFirst = pSegments[i].pData;
+        total += pSegments[i].len;
+    }
+    if (total > MU_MAX_PAYLOAD_LEN)
+        return MU_Modem_Error::InvalidArg;
+    *pLen = (uint8_t)total;
+    return MU_Modem_Error::Ok;
+}
+
+const uint8_t *MU_Modem::m_PrepareTxWire(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                         const TxSeq &seq, uint8_t *pWire, uint8_t *pWireLen)
+{
+    if (!pSegments)
+        return m_EncodeTxPayload(pMsg, len, seq, pWire, pWireLen);
+
+    // Without codec the segments land in the wire buffer directly; the codec needs its input apart from its output
+    bool codec = m_compressEnabled || m_aeadEnabled || m_linkTagEnabled;
+    uint8_t *pFlat = codec ? m_txGather : pWire;
+    uint8_t pos = 0;
+    for (uint8_t i = 0; i < numSegments; i++)
+    {
+        if (pSegments[i].len == 0)
+            continue;
+        memcpy(pFlat + pos, pSegments[i].pData, pSegments[i].len);
+        pos = (uint8_t)(pos + pSegments[i].len);
+    }
+
+    const uint8_t *pOut = m_EncodeTxPayload(pFlat, len, seq, pWire, pWireLen);
+    if (pOut == m_txGather)
+    {
+        // Sent unchanged: the gather buffer is reused by the next dispatch, the slot buffer is not
+        memcpy(pWire, m_txGather, *pWireLen);
+        pOut = pWire;
+    }
+    return pOut;
+}
+
+void MU_Modem::m_AssignTxSeq(TxSeq *pSeq)
+{
+    pSeq->value = 0;
+    pSeq->full = false;
+    pSeq->epoch = m_codecEpoch;
+    if (m_aeadEnabled)
+    {
+        pSeq->value = m_aeadTxCounter++;
+        if (m_aeadSyncLeft > 0 || pSeq->value % MU_AEAD_FULL_SEQ_INTERVAL == 0)
+        {
+            if (m_aeadSyncLeft > 0)
+                m_aeadSyncLeft--;
+            pSeq->full = true;
+        }
+    }
+    else if (m_linkTagEnabled)
+    {
+        pSeq->value = m_linkTagSeq++;
+    }
+}
+
+const uint8_t *MU_Modem::m_EncodeTxPayload(const uint8_t *pMsg, uint8_t len, const TxSeq &seq, uint8_t *pWire, uint8_t *pWireLen)
+{
+    *pWireLen = len;
+    if ((!m_compressEnabled && !m_aeadEnabled && !m_linkTagEnabled) || len == 0)
+        return pMsg;
+
+    uint8_t flags = 0;
+    uint8_t headerLen = MU_CODEC_HEADER_LEN;
+    if (m_aeadEnabled)
+    {
+        flags |= MU_CODEC_FLAG_ENCRYPTED;
+        pWire[headerLen++] = m_aeadNodeId;
+        if (seq.full)
+        {
+            flags |= MU_CODEC_FLAG_FULL_SEQ;
+            pWire[headerLen++] = (uint8_t)(seq.value >> 24);
+            pWire[headerLen++] = (uint8_t)(seq.value >> 16);
+        }
+        pWire[headerLen++] = (uint8_t)(seq.value >> 8);
+        pWire[headerLen++] = (uint8_t)seq.value;
+    }
+    else if (m_linkTagEnabled)
+    {
+        flags |= MU_CODEC_FLAG_LINK_TAG;
+        pWire[headerLen++] = m_linkTagNodeId;
+        pWire[headerLen++] = (uint8_t)seq.value;
+    }
+    bool headerRequired = (flags != 0);
+
+    const uint8_t *pBody = pMsg;
+    uint8_t bodyLen = len;
+    if (m_compressEnabled)
+    {
+        m_compressStats.rawBytes += len;
+
+        // Only worth it if the frame gets shorter. Encrypted and tagged frames carry the codec header anyway.
+        uint16_t packed = 0;
+        uint8_t extra = headerRequired ? 0 : MU_CODEC_HEADER_LEN;
+        if (len > extra + 1)
+        {
+            packed = MU_Compressor::Compress(pMsg, len, pWire + headerLen, len - extra - 1, m_pCompressDict,
+                                             m_compressDictLen);
+        }
+        if (packed > 0)
+        {
+            flags |= MU_CODEC_FLAG_COMPRESSED | (m_compressDictLen ? MU_CODEC_FLAG_DICTIONARY : 0);
+            pBody = pWire + headerLen;
+            bodyLen = (uint8_t)packed;
+            m_compressStats.framesCompressed++;
+        }
+        else
+        {
+            m_compressStats.framesRaw++;
+            if (!headerRequired && pMsg[0] != MU_PROTO_CODEC)
+            {
+                m_compressStats.wireBytes += len;
+                return pMsg;
+            }
+        }
+    }
+
+    uint8_t tagLen = m_aeadEnabled ? m_aeadTagLen : 0;
+    if ((uint16_t)headerLen + bodyLen + tagLen > MU_MAX_PAYLOAD_LEN)
+        return nullptr;
+
+    pWire[0] = MU_PROTO_CODEC;
+    pWire[1] = flags;
+    if (m_aeadEnabled)
+    {
+        // Straight from the caller's buffer (or in place after compression) into the wire image
+        uint8_t nonce[MU_CCM_NONCE_LEN];
+        aeadNonce(m_aeadNodeId, seq.value, nonce);
+        m_aead.Encrypt(nonce, pWire, headerLen, pBody, pWire + headerLen, bodyLen, pWire + headerLen + bodyLen, tagLen);
+        m_securityStats.framesEncrypted++;
+    }
+    else if (pBody == pMsg)
+    {
+        // Tagged, or a raw payload that would be mistaken for a codec frame: wrap it unchanged
+        memcpy(pWire + headerLen, pMsg, len);
+    }
+
+    *pWireLen = (uint8_t)(headerLen + bodyLen + tagLen);
+    if (m_compressEnabled)
+        m_compressStats.wireBytes += *pWireLen;
+    return pWire;
+}
+
+bool MU_Modem::m_DecodeRxPayload(uint8_t *pFrame, uint8_t frameLen, const uint8_t **ppPayload, uint8_t *pLen)
+{
+    *ppPayload = pFrame;
+    *pLen = frameLen;
+    m_rxHasSender = false;
+    // Without a codec configured every frame is application data, even one that starts with MU_PROTO_CODEC
+    bool codec = m_compressEnabled || m_aeadEnabled || m_linkTagEnabled;
+    if (!codec || frameLen < MU_CODEC_HEADER_LEN || pFrame[0] != MU_PROTO_CODEC)
+    {
+        // Plain frame
+        if (!m_aeadEnabled)
+            return true;
+        m_securityStats.plaintextDropped++;
+        return false;
+    }
+
+    uint8_t flags = pFrame[1];
+    uint8_t *pBody = pFrame + MU_CODEC_HEADER_LEN;
+    uint8_t bodyLen = frameLen - MU_CODEC_HEADER_LEN;
+    if (flags & MU_CODEC_FLAG_ENCRYPTED)
+    {
+        uint8_t headerLen = MU_CODEC_HEADER_LEN + 1 + ((flags & MU_CODEC_FLAG_FULL_SEQ) ? 4 : 2);
+        if (!m_aeadEnabled || frameLen < headerLen + m_aeadTagLen)
+        {
+            m_securityStats.authFailures++;
+            return false;
+        }
+
+        uint8_t sender = pFrame[MU_CODEC_HEADER_LEN];
+        uint32_t seq;
+        if (!m_AeadCheckSequence(sender, pFrame + MU_CODEC_HEADER_LEN + 1, flags & MU_CODEC_FLAG_FULL_SEQ, &seq))
+            return false;
+
+        // In place in the receive buffer
+        pBody = pFrame + headerLen;
+        bodyLen = frameLen - headerLen - m_aeadTagLen;
+        uint8_t nonce[MU_CCM_NONCE_LEN];
+        aeadNonce(sender, seq, nonce);
+        if (!m_aead.Decrypt(nonce, pFrame, headerLen, pBody, pBody, bodyLen, pBody + bodyLen, m_aeadTagLen))
+        {
+            m_securityStats.authFailures++;
+            return false;
+        }
+        m_AeadAcceptSequence(sender, seq);
+        m_securityStats.framesDecrypted++;
+        m_rxHasSender = true;
+        m_rxSender = sender;
+        m_rxSeq = (uint8_t)seq;
+    }
+    else if (m_aeadEnabled)
+    {
+        m_securityStats.plaintextDropped++;
+        return false;
+    }
+    else if (flags & MU_CODEC_FLAG_LINK_TAG)
+    {
+        if (bodyLen < MU_LINK_TAG_LEN)
+            return false;
+        m_rxHasSender = true;
+        m_rxSender = pBody[0];
+        m_rxSeq = pBody[1];
+        pBody += MU_LINK_TAG_LEN;
+        bodyLen -= MU_LINK_TAG_LEN;
+    }
+
+    if (!(flags & MU_CODEC_FLAG_COMPRESSED))
+    {
+        *ppPayload = pBody;
+        *pLen = bodyLen;
+        return true;
+    }
+
+    if ((flags & MU_CODEC_FLAG_DICTIONARY) && m_compressDictLen == 0)
+    {
+        m_compressStats.rxErrors++;
+        return false;
+    }
+    int32_t len = MU_Compressor::Decompress(pBody, bodyLen, m_rxDecoded, sizeof(m_rxDecoded),
+                                            (flags & MU_CODEC_FLAG_DICTIONARY) ? m_pCompressDict : nullptr,
+                                            m_compressDictLen);
+    if (len < 0)
+    {
+        m_compressStats.rxErrors++;
+        return false;
+    }
+
+    m_compressStats.rxDecoded++;
+    *ppPayload = m_rxDecoded;
+    *pLen = (uint8_t)len;
+    return true;
+}
+
+// --- Authenticated Encryption ---
+
+MU_Modem_Error MU_Modem::SetEncryption(const uint8_t *pKey, uint8_t nodeId, uint8_t tagLen, uint32_t txCounter)
+{
+    if (!pKey)
+    {
+        m_aeadEnabled = false;
+        m_codecEpoch++;
+        return MU_Modem_Error::Ok;
+    }
+    if (!MU_ENABLE_PAYLOAD_CODEC || tagLen < 4 || tagLen > 16 || (tagLen & 1))
+        return MU_Modem_Error::InvalidArg;
+
+    m_aead.SetKey(pKey);
+    m_aeadNodeId = nodeId;
+    m_aeadTagLen = tagLen;
+    m_aeadTxCounter = txCounter;
+    m_aeadSyncLeft = MU_AEAD_SYNC_FRAMES;
+    memset(m_aeadPeers, 0, sizeof(m_aeadPeers));
+    m_aeadEnabled = true;
+    m_codecEpoch++; // Queued frames must not keep counters of the old key
+    return MU_Modem_Error::Ok;
+}
+
+uint8_t MU_Modem::GetMaxPayloadLen() const
+{
+    if (m_aeadEnabled)
+        return MU_MAX_PAYLOAD_LEN - MU_AEAD_HEADER_MAX_LEN - m_aeadTagLen;
+    if (m_linkTagEnabled)
+        return MU_MAX_PAYLOAD_LEN - MU_CODEC_HEADER_LEN - MU_LINK_TAG_LEN;
+    return MU_MAX_PAYLOAD_LEN;
+}
+
+MU_Modem_Error MU_Modem::GetSecurityStats(MU_Modem_SecurityStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_securityStats;
+    return MU_Modem_Error::Ok;
+}
+
+bool MU_Modem::m_AeadCheckSequence(uint8_t sender, const uint8_t *pSeq, bool fullSeq, uint32_t *pSeq32)
+{
+    if (sender == m_aeadNodeId)
+    {
+        // Our own frame repeated back to us
+        m_securityStats.replays++;
+        return false;
+    }
+
+    const AeadPeer *pPeer = nullptr;
+    for (uint8_t i = 0; i < MU_AEAD_MAX_PEERS; i++)
+    {
+        if (m_aeadPeers[i].valid && m_aeadPeers[i].sender == sender)
+        {
+            pPeer = &m_aeadPeers[i];
+            break;
+        }
+    }
+
+    uint32_t seq;
+    if (fullSeq)
+    {
+        seq = ((uint32_t)pSeq[0] << 24) | ((uint32_t)pSeq[1] << 16) | ((uint32_t)pSeq[2] << 8) | pSeq[3];
+    }
+    else
+    {
+        if (!pPeer)
+        {
+            m_securityStats.unsynced++;
+            return false;
+        }
+        // The counter closest to the highest one seen that ends in these 16 bits
+        uint16_t low = (uint16_t)((pSeq[0] << 8) | pSeq[1]);
+        int16_t delta = (int16_t)(low - (uint16_t)pPeer->highest);
+        seq = pPeer->highest + (int32_t)delta;
+    }
+
+    if (pPeer && seq <= pPeer->highest)
+    {
+        uint32_t age = pPeer->highest - seq;
+        if (age >= MU_AEAD_REPLAY_WINDOW || (pPeer->window & (1UL << age)))
+        {
+            m_securityStats.replays++;
+            return false;
+        }
+    }
+    *pSeq32 = seq;
+    return true;
+}
+
+void MU_Modem::m_AeadAcceptSequence(uint8_t sender, uint32_t seq)
+{
+    // Only called for authenticated frames, so a forged frame can't advance the window
+    AeadPeer *pPeer = nullptr;
+    AeadPeer *pOldest = &m_aeadPeers[0];
+    for (uint8_t i = 0; i < MU_AEAD_MAX_PEERS; i++)
+    {
+        AeadPeer &peer = m_aeadPeers[i];
+        if (peer.valid && peer.sender == sender)
+        {
+            pPeer = &peer;
+            break;
+        }
+        if (pOldest->valid && (!peer.valid || peer.lastRxAt - pOldest->lastRxAt > 0x80000000UL))
+            pOldest = &peer;
+    }
+
+    if (!pPeer)
+    {
+        pPeer = pOldest;
+        pPeer->valid = true;
+        pPeer->sender = sender;
+        pPeer->highest = seq;
+        pPeer->window = 1;
+    }
+    else if (seq > pPeer->highest)
+    {
+        uint32_t shift = seq - pPeer->highest;
+        pPeer->window = (shift >= MU_AEAD_REPLAY_WINDOW) ? 1 : ((pPeer->window << shift) | 1);
+        pPeer->highest = seq;
+    }
+    else
+    {
+        pPeer->window |= 1UL << (pPeer->highest - seq);
+    }
+    pPeer->lastRxAt = millis();
+}
+
+bool MU_Modem::m_IsModemTxReady()
+{
+    return m_pFlowControl == nullptr || !m_pFlowControl->IsModemBusy();
+}
+
+MU_Modem_Error MU_Modem::m_WaitModemTxReady(uint32_t timeoutMs)
+{
+    uint32_t start = millis();
+    while (!m_IsModemTxReady())
+    {
+        if (millis() - start >= timeoutMs)
+            return MU_Modem_Error::Busy;
+        Work();
+        delay(1);
+    }
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::m_UpdateRxThrottle()
+{
+    if (m_pFlowControl == nullptr)
+        return;
+
+    // The driver holds one received packet for a polling application, and the next *DR would overwrite it.
+    // A callback consumes every frame inside parse(), so nothing stays held then.
+    // Released only when the packet is consumed (DeletePacket()) or discarded by the parser.
+    bool full = m_drMessagePresent && m_pCallback == nullptr;
+    if (!m_rxThrottled && full)
+    {
+        m_rxThrottled = true;
+        m_rxThrottleStart = millis();
+        m_flowStats.rxThrottles++;
+        m_pFlowControl->SetHostBusy(true);
+    }
+    else if (m_rxThrottled && !full)
+    {
+        m_rxThrottled = false;
+        m_flowStats.rxThrottledMs += millis() - m_rxThrottleStart;
+        m_pFlowControl->SetHostBusy(false);
+    }
+}
+
+void MU_Modem::m_NotifyWritable()
+{
+    for (uint8_t cls = 0; cls < MU_PRIORITY_CLASS_COUNT; ++cls)
+    {
+        if (!m_writableArmed[cls])
+            continue;
+        MU_Modem_Priority priority = static_cast<MU_Modem_Priority>(cls);
+        if (GetTxFreeSlots(priority) == 0 || GetTxFreeBytes(priority) < m_writableMinBytes[cls])
+            continue;
+
+        m_writableArmed[cls] = false;
+        m_EmitEvent(MU_Modem_Event(MU_Modem_Error::Ok, MU_Modem_Response::TxWritable, cls));
+    }
+}
+
+uint8_t MU_Modem::GetTxFreeSlots(MU_Modem_Priority priority) const
+{
+    uint8_t cls = static_cast<uint8_t>(priority);
+    if (cls >= MU_PRIORITY_CLASS_COUNT)
+        return 0;
+    // Requeued retries may temporarily use the reserve beyond MU_CMD_QUEUE_DEPTH
+    return (m_queueCount[cls] < MU_CMD_QUEUE_DEPTH) ? MU_CMD_QUEUE_DEPTH - m_queueCount[cls] : 0;
+}
+
+uint16_t MU_Modem::GetTxFreeBytes(MU_Modem_Priority priority) const
+{
+    uint8_t cls = static_cast<uint8_t>(priority);
+    if (cls >= MU_PRIORITY_CLASS_COUNT || m_queueCount[cls] >= MU_CMD_QUEUE_DEPTH)
+        return 0;
+    return MU_TX_QUEUE_MAX_BYTES - m_queueBytes[cls];
+}
+
+void MU_Modem::RequestWritableNotification(MU_Modem_Priority priority, uint16_t minFreeBytes)
+{
+    uint8_t cls = static_cast<uint8_t>(priority);
+    if (cls >= MU_PRIORITY_CLASS_COUNT)
+        return;
+    m_writableArmed[cls] = true;
+    m_writableMinBytes[cls] = minFreeBytes;
+}
+
+MU_Modem_Error MU_Modem::TransmitDataAsyncWait(const uint8_t *pMsg, uint8_t len, uint32_t timeoutMs, bool useRouteRegister, MU_Modem_Priority priority)
+{
+    uint32_t start = millis();
+    while (true)
+    {
+        MU_Modem_Error err = TransmitDataAsync(pMsg, len, useRouteRegister, priority);
+        if (err != MU_Modem_Error::Busy)
+            return err;
+        if (millis() - start >= timeoutMs)
+            return MU_Modem_Error::Timeout;
+        Work(); // Drain the queue while waiting
+        delay(1);
+    }
+}
+
+void MU_Modem::SetFlowControlPins(int8_t rtsPin, int8_t ctsPin)
+{
+    m_pinFlowControl.begin(rtsPin, ctsPin);
+    SetFlowControl((rtsPin >= 0 || ctsPin >= 0) ? &m_pinFlowControl : nullptr);
+}
+
+void MU_Modem::SetFlowControl(MU_Modem_FlowControl *pFlowControl)
+{
+    // Never leave the modem paused by a driver that is being replaced
+    if (m_pFlowControl != nullptr && m_rxThrottled)
+        m_pFlowControl->SetHostBusy(false);
+    m_rxThrottled = false;
+    m_pFlowControl = pFlowControl;
+    m_UpdateRxThrottle();
+}
+
+MU_Modem_Error MU_Modem::GetFlowControlStats(MU_Modem_FlowControlStats *pStats) const
+{
+    if (!pStats)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_flowStats;
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::GetQueueStats(MU_Modem_Priority priority, MU_Modem_QueueStats *pStats) const
+{
+    uint8_t cls = static_cast<uint8_t>(priority);
+    if (!pStats || cls >= MU_PRIORITY_CLASS_COUNT)
+        return MU_Modem_Error::InvalidArg;
+    *pStats = m_queueStats[cls];
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::ResetQueueStats()
+{
+    memset(m_queueStats, 0, sizeof(m_queueStats));
+    for (uint8_t cls = 0; cls < MU_PRIORITY_CLASS_COUNT; ++cls)
+    {
+        m_queueStats[cls].depth = m_queueCount[cls];
+        m_queueStats[cls].maxDepth = m_queueCount[cls];
+    }
+}
+
+// --- Parser Implementation ---
+
+void MU_Modem::m_ResetParser()
+{
+    m_parserState = MU_Modem_ParserState::Start;
+    m_drMessageLen = 0;
+    m_drNumRouteNodes = 0;
+    m_drMessagePresent = false;
+    m_rxUndecided = false;
+    m_rxDropping = false;
+    if (m_rxStreaming)
+        m_EndRxStream(MU_Modem_Error::Fail);
+    m_UpdateRxThrottle();
+}
+
+ModemParseResult MU_Modem::parse()
+{
+    while (true)
+    {
+        int c_int = readByte();
+        if (c_int == -1)
+        {
+            // Hand over what has arrived so far instead of waiting for a full chunk
+            if (m_rxStreaming)
+                m_FlushRxChunk();
+            break;
+        }
+        uint8_t c = static_cast<uint8_t>(c_int);
+
+        switch (m_parserState)
+        {
+        case MU_Modem_ParserState::Start:
+            if (c == '*')
+            {
+                m_respStartUs = micros();
+                _rxIndex = 0;
+                _rxBuffer[_rxIndex++] = c;
+                m_parserState = MU_Modem_ParserState::ReadCmdPrefix;
+            }
+            break;
+
+        case MU_Modem_ParserState::ReadCmdPrefix:
+        {
+            ModemParseResult res = m_HandleReadCmdPrefix(c);
+            if (res != ModemParseResult::Parsing)
+                return res;
+        }
+        break;
+
+        case MU_Modem_ParserState::RadioDrSize:
+        {
+            ModemParseResult res = m_HandleRadioDrSize(c);
+            if (res != ModemParseResult::Parsing)
+                return res;
+        }
+        break;
+
+        case MU_Modem_ParserState::RadioDsRssi:
+        {
+            ModemParseResult res = m_HandleRadioDsRssi(c);
+            if (res != ModemParseResult::Parsing)
+                return res;
+        }
+        break;
+
+        case MU_Modem_ParserState::RadioDrPayload:
+        {
+            ModemParseResult res = m_HandleRadioDrPayload(c);
+            if (res != ModemParseResult::Parsing)
+                return res;
+        }
+        break;
+
+        case MU_Modem_ParserState::ReadOptionUntilLF:
+        {
+            ModemParseResult res = m_HandleReadOptionUntilLF(c);
+            if (res != ModemParseResult::Parsing)
+                return res;
+        }
+        break;
+
+        default:
+            m_ResetParser();
+            return ModemParseResult::Garbage;
+        }
+    }
+    return ModemParseResult::Parsing;
+}
+
+ModemParseResult MU_Modem::m_HandleReadCmdPrefix(uint8_t c)
+{
+    if (_rxIndex < RX_BUFFER_SIZE)
+        _rxBuffer[_rxIndex++] = c;
+
+    // Check for *DR=, *DS= or *DC= (Data Reception)
+    if (_rxIndex == MU_DR_PREFIX_LEN)
+    {
+        if (strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DR, MU_DR_PREFIX_LEN) == 0)
+        {
+            m_rxHasRssi = false;
+            m_parserState = MU_Modem_ParserState::RadioDrSize;
+            return ModemParseResult::Parsing;
+        }
+        if (strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DS, MU_DS_PREFIX_LEN) == 0 ||
+            strncmp((char *)_rxBuffer, MU_RECEPTION_PREFIX_DC, MU_DS_PREFIX_LEN) == 0)
+        {
+            m_parserState = MU_Modem_ParserState::RadioDsRssi;
+            return ModemParseResult::Parsing;
+        }
+    }
+
+    // Check for CR/LF (End of standard command response)
+    if (c == '\n')
+    {
+        if (_rxIndex > 0)
+        {
+            _rxIndex--;
+            _rxBuffer[_rxIndex] = 0;
+        }
+        if (_rxIndex > 0 && _rxBuffer[_rxIndex - 1] == '\r')
+        {
+            _rxIndex--;
+            _rxBuffer[_rxIndex] = 0;
+        }
+
+        m_parserState = MU_Modem_ParserState::Start;
+
+        // Check for LBT Error (*IR=01)
+        if (strncmp((char *)_rxBuffer, MU_LBT_ERROR_RESPONSE, 6) == 0)
+        {
+            m_lbtErrorDetected = true;
+            if (!m_OnLbtError())
+            {
+                m_EmitEvent(MU_Modem_Event(MU_Modem_Error::FailLbt, MU_Modem_Response::TxFailed));
+            }
+            return ModemParseResult::FinishedCmdResponse;
+        }
+
+        return ModemParseResult::FinishedCmdResponse;
+    }
+    return ModemParseResult::Parsing;
+}
+
+ModemParseResult MU_Modem::m_HandleRadioDrSize(uint8_t c)
+{
+    if (_rxIndex < RX_BUFFER_SIZE)
+        _rxBuffer[_rxIndex++] = c;
+    if (_rxIndex == MU_DR_SIZE_TOTAL_LEN)
+    {
+        uint32_t len;
+        if (parseHex(&_rxBuffer[MU_HEX_VAL_OFFSET], 2, &len))
+        {
+            m_drMessageLen = (uint8_t)len;
+            m_parserState = MU_Modem_ParserState::RadioDrPayload;
+            _rxIndex = 0;
+            m_drNumRouteNodes = 0; // Not every frame carries route information
+            m_rxChunkLen = 0;
+            m_rxStreaming = false;
+            m_rxDropping = false;
+
+            // RSSI and length are known: decide now unless the filters need payload bytes
+            m_rxUndecided = true;
+            m_rxDecideAt = (m_rxFilterPrefixMax < m_drMessageLen) ? m_rxFilterPrefixMax : m_drMessageLen;
+            if (m_rxFilterCount == 0 || m_rxDecideAt == 0)
+                m_DecideRxFrame();
+            return ModemParseResult::Parsing;
+        }
+        else
+        {
+            m_parserState = MU_Modem_ParserState::Start;
+            return ModemParseResult::Garbage;
+        }
+    }
+    return ModemParseResult::Parsing;
+}
+
+ModemParseResult MU_Modem::m_HandleRadioDsRssi(uint8_t c)
+{
+    if (_rxIndex < RX_BUFFER_SIZE)
+        _rxBuffer[_rxIndex++] = c;
+    if (_rxIndex == MU_DS_RSSI_TOTAL_LEN)
+    {
+        uint32_t rssiVal;
+        if (parseHex(&_rxBuffer[MU_HEX_VAL_OFFSET], 2, &rssiVal))
+        {
+            m_lastRxRSSI = -static_cast<int16_t>(rssiVal);
+            m_rxHasRssi = true;
+            // After RSSI, the format is the same as *DR (size, payload, etc.)
+            // So, transition to the size-parsing state.
+            m_parserState = MU_Modem_ParserState::RadioDrSize;
+            _rxIndex = MU_DR_PREFIX_LEN; // Pretend we just saw "*DR=" to reuse the logic
+            return ModemParseResult::Parsing;
+        }
+        else
+        {
+            m_parserState = MU_Modem_ParserState::Start;
+            return ModemParseResult::Garbage;
+        }
+    }
+    return ModemParseResult::Parsing;
+}
+
+ModemParseResult MU_Modem::m_HandleRadioDrPayload(uint8_t c)
+{
+    if (m_rxStreaming || m_rxDropping)
+    {
+        // Past the decision the payload bypasses _rxBuffer; only the options after it are buffered (from index 0)
+        if (m_rxStreaming)
+        {
+            m_rxChunk[m_rxChunkLen++] = c;
+            if (m_rxChunkLen == MU_RX_SINK_CHUNK_LEN)
+                m_FlushRxChunk();
+        }
+        _rxIndex++;
+    }
+    else
+    {
+        if (_rxIndex < m_drMessageLen)
+        {
+            if (_rxIndex < RX_BUFFER_SIZE)
+                _rxBuffer[_rxIndex] = c;
+            _rxIndex++;
+        }
+        if (m_rxUndecided && _rxIndex == m_rxDecideAt)
+            m_DecideRxFrame();
+    }
+
+    if (_rxIndex == m_drMessageLen)
+    {
+        if (m_rxStreaming || m_rxDropping)
+        {
+            m_FlushRxChunk();
+            _rxIndex = 0;
+        }
+        m_parserState = MU_Modem_ParserState::ReadOptionUntilLF;
+    }
+    return ModemParseResult::Parsing;
+}
+
+ModemParseResult MU_Modem::m_HandleReadOptionUntilLF(uint8_t c)
+{
+    // A dropped frame only has to be followed to its LF
+    if (!m_rxDropping && _rxIndex < RX_BUFFER_SIZE)
+        _rxBuffer[_rxIndex++] = c;
 
     if (c == '\n')
     {
         size_t optLen = strlen(MU_ROUTE_INFO_OPTION_PREFIX);
-        if (_rxIndex > m_drMessageLen + optLen)
+        uint8_t optStart = (m_rxStreaming || m_rxDropping) ? 0 : m_drMessageLen;
+        if (!m_rxDropping && _rxIndex > optStart + optLen)
         {
-            const char *pOpt = (const char *)&_rxBuffer[m_drMessageLen];
+            const char *pOpt = (const char *)&_rxBuffer[optStart];
             const char *pEnd = (const char *)&_rxBuffer[_rxIndex];
 
             while (pOpt <= pEnd - optLen)
@@ -493,197 +2220,780 @@ ModemParseResult MU_Modem::m_HandleReadOptionUntilLF(uint8_t c)
             }
         }
 
-        m_drMessagePresent = true;
+        if (!m_rxDropping)
+        {
+            m_drMessagePresent = true;
+            m_UpdateRxThrottle();
+        }
         m_parserState = MU_Modem_ParserState::Start;
         return ModemParseResult::FinishedDrResponse;
     }
     else if (_rxIndex >= RX_BUFFER_SIZE)
     {
-        m_parserState = MU_Modem_ParserState::Start;
-        return ModemParseResult::Overflow;
+        m_parserState = MU_Modem_ParserState::Start;
+        m_rxDropping = false;
+        if (m_rxStreaming)
+            m_EndRxStream(MU_Modem_Error::BufferTooSmall);
+        return ModemParseResult::Overflow;
+    }
+    return ModemParseResult::Parsing;
+}
+
+void MU_Modem::m_FlushRxChunk()
+{
+    if (m_rxChunkLen == 0)
+        return;
+    if (m_pRxSink)
+        m_pRxSink->OnRxData(*this, m_rxChunk, m_rxChunkLen);
+    m_rxChunkLen = 0;
+}
+
+void MU_Modem::m_EndRxStream(MU_Modem_Error err)
+{
+    m_rxStreaming = false;
+    m_FlushRxChunk();
+    m_rxStartUs = m_respStartUs;
+    if (err == MU_Modem_Error::Ok && m_drNumRouteNodes > 0)
+        m_UpdateNeighbor(m_drRouteInfo[0], m_lastRxRSSI, false, 0);
+    if (!m_pRxSink)
+        return;
+
+    MU_Modem_Event ev(err, MU_Modem_Response::DataReceived, m_lastRxRSSI);
+    ev.payloadLen = m_drMessageLen;
+    ev.pRouteNodes = m_drRouteInfo;
+    ev.numRouteNodes = m_drNumRouteNodes;
+    ev.timestampUs = m_respStartUs;
+    ev.wireLen = m_drMessageLen;
+    m_pRxSink->OnRxEnd(*this, ev);
+}
+
+// --- Callbacks ---
+
+void MU_Modem::onRxDataReceived()
+{
+    // Called when parse() returns FinishedDrResponse
+    if (m_rxDropping)
+    {
+        // Rejected by a receive filter while it arrived
+        m_rxDropping = false;
+        return;
+    }
+    if (m_rxStreaming)
+    {
+        // The payload already went to the sink piece by piece
+        m_EndRxStream(MU_Modem_Error::Ok);
+        return;
+    }
+
+    // 0. Undo the transmit-side payload codec: authenticate, decrypt, decompress (no-op for plain frames)
+    const uint8_t *pPayload;
+    uint8_t payloadLen;
+    m_rxStartUs = m_respStartUs;
+    if (!m_DecodeRxPayload(_rxBuffer, m_drMessageLen, &pPayload, &payloadLen))
+        return;
+
+    // Copies of a frame received over several relays are dropped here
+    if (m_dedupEnabled && m_IsDuplicate())
+        return;
+
+    // Link quality bookkeeping, keyed on the codec's sender or else the route information's originator
+    if (m_rxHasSender)
+        m_UpdateNeighbor(m_rxSender, m_lastRxRSSI, true, m_rxSeq);
+    else if (m_drNumRouteNodes > 0)
+        m_UpdateNeighbor(m_drRouteInfo[0], m_lastRxRSSI, false, 0);
+
+    // 1. Fire Async Callback (Zero Copy)
+    // Pass the _rxBuffer directly.
+    // Note: This buffer is volatile and will be overwritten by the next modem activity.
+    if (!m_blockAsyncCallback)
+    {
+        MU_Modem_Event ev(MU_Modem_Error::Ok, MU_Modem_Response::DataReceived, m_lastRxRSSI);
+        ev.pPayload = pPayload;
+        ev.payloadLen = payloadLen;
+        ev.pRouteNodes = m_drRouteInfo;
+        ev.numRouteNodes = m_drNumRouteNodes;
+        ev.timestampUs = m_rxStartUs;
+        ev.wireLen = m_drMessageLen;
+        m_EmitEvent(ev);
+    }
+
+    // 2. Legacy Support (Copy if buffer provided)
+    if (m_pLegacyBuffer != nullptr && m_legacyBufferSize >= payloadLen)
+    {
+        memcpy(m_pLegacyBuffer, pPayload, payloadLen);
+        // Ensure null termination if there is enough space
+        if (m_legacyBufferSize > payloadLen)
+        {
+            m_pLegacyBuffer[payloadLen] = '\0';
+        }
+        m_legacyPacketLen = payloadLen;
+        m_drMessagePresent = true;
+    }
+}
+
+void MU_Modem::onCommandComplete(ModemError result)
+{
+    // Called by Base when a command (async or sync) finishes
+    QueuedCommand done = {};
+    MU_Modem_Response expected = MU_Modem_Response::Idle;
+    if (m_PopInFlight(&done))
+    {
+        done.respUs = m_respStartUs;
+        expected = done.expected;
+        if (done.isCarrierSense)
+        {
+            // Internal pre-check of the retry scheduler, not reported to the application
+            m_OnCarrierSenseResult(getRxBuffer());
+            return;
+        }
+        if (done.isTx && m_retryPolicy.maxAttempts > 1)
+        {
+            const uint8_t *rxBuf = getRxBuffer();
+            if (done.lbtFailed || strncmp((const char *)rxBuf, MU_INFORMATION_RESPONSE_PREFIX, strlen(MU_INFORMATION_RESPONSE_PREFIX)) == 0)
+            {
+                m_OnTxLbtFailure(done);
+                return;
+            }
+            if (result == ModemError::Ok && strncmp((const char *)rxBuf, MU_TRANSMISSION_RESPONSE_PREFIX, strlen(MU_TRANSMISSION_RESPONSE_PREFIX)) == 0)
+            {
+                // Accepted; TxComplete is reported once the LBT window passes without *IR=01
+                m_AwaitTxVerdict(done);
+                return;
+            }
+        }
+    }
+
+    // The shadow follows asynchronous configuration whether or not anybody listens for the event
+    if (result == ModemError::Ok && (expected == MU_Modem_Response::Channel || expected == MU_Modem_Response::Power))
+    {
+        bool isChannel = expected == MU_Modem_Response::Channel;
+        uint32_t value;
+        if (parseResponseHex(getRxBuffer(), getRxIndex(), isChannel ? MU_SET_CHANNEL_RESPONSE_PREFIX : MU_SET_POWER_RESPONSE_PREFIX, 2,
+                             &value) == ModemError::Ok)
+            m_UpdateShadow(isChannel ? MU_SHADOW_CHANNEL : MU_SHADOW_POWER, (uint8_t)value);
+    }
+
+    if (m_pCallback || m_pLayers)
+    {
+        MU_Modem_Event ev(result, MU_Modem_Response::GenericResponse);
+
+        const uint8_t *rxBuf = getRxBuffer();
+        uint16_t rxLen = getRxIndex();
+
+        // Check if response is an error (*ER=XX)
+        bool isErrorResp = (rxLen >= MU_ERROR_RESPONSE_PREFIX_LEN + 2 && strncmp((const char *)rxBuf, MU_ERROR_RESPONSE_PREFIX, MU_ERROR_RESPONSE_PREFIX_LEN) == 0);
+        if (isErrorResp)
+        {
+            uint32_t errCode;
+            if (parseHex(rxBuf + MU_ERROR_RESPONSE_PREFIX_LEN, 2, &errCode))
+            {
+                ev.value = (int32_t)errCode;
+            }
+            if (result == ModemError::Ok)
+            {
+                // If base thought it was OK but it's an error code from modem
+                ev.error = ModemError::Fail;
+            }
+        }
+
+        if (expected != MU_Modem_Response::Idle)
+        {
+            ev.type = expected;
+
+            if (ev.error == ModemError::Ok)
+            {
+                // Parse specific value based on expected response
+                if (ev.type == MU_Modem_Response::RssiCurrentChannel)
+                {
+                    uint8_t rawRssi;
+                    if (parseResponseHex(rxBuf, rxLen, MU_GET_RSSI_CURRENT_CHANNEL_RESPONSE_PREFIX, 2, (uint32_t *)&rawRssi) == ModemError::Ok)
+                        ev.value = -(int16_t)rawRssi;
+                }
+                else if (ev.type == MU_Modem_Response::SerialNumber)
+                {
+                    const char *pData = strchr((const char *)rxBuf, '=');
+                    if (pData)
+                    {
+                        pData++; // Skip '='
+                        if (isalpha((unsigned char)*pData))
+                            pData++; // Skip 'E' etc.
+                        uint32_t sn;
+                        if (parseHex((const uint8_t *)pData, 8, &sn))
+                            ev.value = (int32_t)sn;
+                    }
+                }
+                else if (ev.type == MU_Modem_Response::RssiAllChannels)
+                {
+                    size_t prefixLen = strlen(MU_GET_RSSI_ALL_CHANNELS_RESPONSE_PREFIX);
+                    if (rxLen >= prefixLen)
+                    {
+                        ev.pPayload = rxBuf + prefixLen;
+                        ev.payloadLen = rxLen - prefixLen;
+                    }
+                }
+                else if (ev.type == MU_Modem_Response::Channel)
+                {
+                    uint8_t ch;
+                    if (parseResponseHex(rxBuf, rxLen, MU_SET_CHANNEL_RESPONSE_PREFIX, 2, (uint32_t *)&ch) == ModemError::Ok)
+                        ev.value = ch;
+                }
+                else if (ev.type == MU_Modem_Response::GroupID)
+                {
+                    uint8_t gi;
+                    if (parseResponseHex(rxBuf, rxLen, MU_SET_GROUP_RESPONSE_PREFIX, 2, (uint32_t *)&gi) == ModemError::Ok)
+                        ev.value = gi;
+                }
+                else if (ev.type == MU_Modem_Response::EquipmentID)
+                {
+                    uint8_t ei;
+                    if (parseResponseHex(rxBuf, rxLen, MU_SET_EQUIPMENT_RESPONSE_PREFIX, 2, (uint32_t *)&ei) == ModemError::Ok)
+                        ev.value = ei;
+                }
+                else if (ev.type == MU_Modem_Response::DestinationID)
+                {
+                    uint8_t di;
+                    if (parseResponseHex(rxBuf, rxLen, MU_SET_DESTINATION_RESPONSE_PREFIX, 2, (uint32_t *)&di) == ModemError::Ok)
+                        ev.value = di;
+                }
+                else if (ev.type == MU_Modem_Response::Power)
+                {
+                    uint32_t pw;
+                    if (parseResponseHex(rxBuf, rxLen, MU_SET_POWER_RESPONSE_PREFIX, 2, &pw) == ModemError::Ok)
+                        ev.value = (int32_t)pw;
+                }
+            }
+        }
+        else
+        {
+            // If it was a DataTx command, notify Tx status
+            bool isDtResp = strncmp((const char *)rxBuf, MU_TRANSMISSION_RESPONSE_PREFIX, strlen(MU_TRANSMISSION_RESPONSE_PREFIX)) == 0;
+            if (done.isTx)
+            {
+                // Queued frame: report which buffer finished so its owner may reuse it
+                ev.type = (ev.error == ModemError::Ok && isDtResp) ? MU_Modem_Response::TxComplete : MU_Modem_Response::TxFailed;
+                ev.pPayload = done.pMsg;
+                ev.payloadLen = done.len;
+                ev.timestampUs = done.respUs;
+                ev.wireLen = done.wireLen;
+            }
+            else if (isDtResp)
+            {
+                ev.type = (ev.error == ModemError::Ok) ? MU_Modem_Response::TxComplete : MU_Modem_Response::TxFailed;
+                ev.timestampUs = m_respStartUs;
+            }
+            else if (isErrorResp)
+            {
+                // If it's an error response and no specific async request,
+                // it might be a failure of a simple command or DataTx.
+            }
+        }
+
+        m_EmitEvent(ev);
+    }
+}
+
+void MU_Modem::m_EmitEventFrom(MU_Modem_Layer *pLayer, const MU_Modem_Event &ev)
+{
+    // Attached layers see every event first and may consume their own traffic
+    for (; pLayer != nullptr; pLayer = pLayer->m_pNextLayer)
+    {
+        if (pLayer->OnModemEvent(*this, ev))
+            return;
+    }
+    if (m_pCallback)
+        m_pCallback(ev);
+}
+
+void MU_Modem_Layer::EmitEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    modem.m_EmitEventFrom(m_pNextLayer, event);
+}
+
+uint8_t MU_Modem_Layer::GetLayerFrameLen(const MU_Modem &modem)
+{
+    uint8_t len = modem.GetMaxPayloadLen();
+    return (len < MU_LAYER_PAYLOAD_LEN) ? len : MU_LAYER_PAYLOAD_LEN;
+}
+
+// --- Protocol Layers ---
+
+MU_Modem_Error MU_Modem::AttachLayer(MU_Modem_Layer *pLayer)
+{
+    if (!pLayer)
+        return MU_Modem_Error::InvalidArg;
+    MU_Modem_Layer **ppLink = &m_pLayers;
+    while (*ppLink != nullptr)
+    {
+        if (*ppLink == pLayer)
+            return MU_Modem_Error::Ok; // Already attached
+        ppLink = &(*ppLink)->m_pNextLayer;
+    }
+    pLayer->m_pNextLayer = nullptr;
+    *ppLink = pLayer;
+    return MU_Modem_Error::Ok;
+}
+
+void MU_Modem::DetachLayer(MU_Modem_Layer *pLayer)
+{
+    for (MU_Modem_Layer **ppLink = &m_pLayers; *ppLink != nullptr; ppLink = &(*ppLink)->m_pNextLayer)
+    {
+        if (*ppLink == pLayer)
+        {
+            *ppLink = pLayer->m_pNextLayer;
+            pLayer->m_pNextLayer = nullptr;
+            return;
+        }
+    }
+}
+
+bool MU_Modem::m_IsTxGateOpen(uint8_t wireLen)
+{
+    if (!m_pLayers)
+        return true;
+
+    // A pipelined frame starts only when the ones before it are done
+    uint32_t aheadUs = 0;
+    for (uint8_t i = 0; i < m_inFlightCount; i++)
+    {
+        const QueuedCommand &c = m_inFlight[(m_inFlightHead + i) % MU_TX_PIPELINE_DEPTH];
+        if (c.isTx)
+            aheadUs += GetFrameAirtimeUs(c.wireLen);
+    }
+
+    for (MU_Modem_Layer *pLayer = m_pLayers; pLayer != nullptr; pLayer = pLayer->m_pNextLayer)
+    {
+        if (!pLayer->OnModemTxGate(*this, wireLen, aheadUs))
+            return false;
+    }
+    return true;
+}
+
+// --- Configuration Shadow ---
+
+void MU_Modem::m_UpdateShadow(uint8_t field, uint8_t value)
+{
+    switch (field)
+    {
+    case MU_SHADOW_CHANNEL:
+        m_shadow.channel = value;
+        break;
+    case MU_SHADOW_GROUP_ID:
+        m_shadow.groupId = value;
+        break;
+    case MU_SHADOW_EQUIPMENT_ID:
+        m_shadow.equipmentId = value;
+        break;
+    case MU_SHADOW_DESTINATION_ID:
+        m_shadow.destinationId = value;
+        break;
+    case MU_SHADOW_POWER:
+        m_shadow.power = value;
+        break;
+    default:
+        return;
+    }
+    m_shadow.validMask |= field;
+}
+
+MU_Modem_Error MU_Modem::m_VerifyShadow(const MU_Modem_ConfigShadow &expected)
+{
+    // Only the fields the caller captured are compared
+    struct
+    {
+        uint8_t field;
+        uint8_t value;
+        MU_Modem_Error (MU_Modem::*getter)(uint8_t *);
+    } const checks[] = {
+        {MU_SHADOW_CHANNEL, expected.channel, &MU_Modem::GetChannel},
+        {MU_SHADOW_GROUP_ID, expected.groupId, &MU_Modem::GetGroupID},
+        {MU_SHADOW_EQUIPMENT_ID, expected.equipmentId, &MU_Modem::GetEquipmentID},
+        {MU_SHADOW_DESTINATION_ID, expected.destinationId, &MU_Modem::GetDestinationID},
+        {MU_SHADOW_POWER, expected.power, &MU_Modem::GetPower},
+    };
+    for (const auto &check : checks)
+    {
+        if ((expected.validMask & check.field) == 0)
+            continue;
+        uint8_t actual;
+        MU_Modem_Error err = (this->*check.getter)(&actual);
+        if (err != MU_Modem_Error::Ok)
+            return err;
+        if (actual != check.value)
+            return MU_Modem_Error::Fail;
+    }
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::m_ApplyShadow(const MU_Modem_ConfigShadow &shadow)
+{
+    // Restore volatile settings after a reset (never written to NVM)
+    MU_Modem_Error err = MU_Modem_Error::Ok;
+    if (err == MU_Modem_Error::Ok && (shadow.validMask & MU_SHADOW_CHANNEL))
+        err = SetChannel(shadow.channel, false);
+    if (err == MU_Modem_Error::Ok && (shadow.validMask & MU_SHADOW_GROUP_ID))
+        err = SetGroupID(shadow.groupId, false);
+    if (err == MU_Modem_Error::Ok && (shadow.validMask & MU_SHADOW_EQUIPMENT_ID))
+        err = SetEquipmentID(shadow.equipmentId, false);
+    if (err == MU_Modem_Error::Ok && (shadow.validMask & MU_SHADOW_DESTINATION_ID))
+        err = SetDestinationID(shadow.destinationId, false);
+    if (err == MU_Modem_Error::Ok && (shadow.validMask & MU_SHADOW_POWER))
+        err = SetPower(shadow.power, false);
+    return err;
+}
+
+MU_Modem_Error MU_Modem::GetConfigShadow(MU_Modem_ConfigShadow *pShadow) const
+{
+    if (!pShadow)
+        return MU_Modem_Error::InvalidArg;
+    *pShadow = m_shadow;
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::CaptureConfigShadow(MU_Modem_ConfigShadow *pShadow)
+{
+    uint8_t value;
+    MU_Modem_Error err = GetChannel(&value);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_CHANNEL, value);
+        err = GetGroupID(&value);
+    }
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_GROUP_ID, value);
+        err = GetEquipmentID(&value);
+    }
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_EQUIPMENT_ID, value);
+        err = GetDestinationID(&value);
+    }
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_DESTINATION_ID, value);
+        err = GetPower(&value);
+    }
+    if (err == MU_Modem_Error::Ok)
+        m_UpdateShadow(MU_SHADOW_POWER, value);
+    if (err == MU_Modem_Error::Ok && pShadow)
+        *pShadow = m_shadow;
+    return err;
+}
+
+// --- Staged Configuration ---
+
+// Returns the MU_NVM_* fields whose values differ
+static uint8_t nvmDiff(const MU_Modem_NvmConfig &a, const MU_Modem_NvmConfig &b)
+{
+    uint8_t diff = 0;
+    if (a.channel != b.channel)
+        diff |= MU_NVM_CHANNEL;
+    if (a.groupId != b.groupId)
+        diff |= MU_NVM_GROUP_ID;
+    if (a.equipmentId != b.equipmentId)
+        diff |= MU_NVM_EQUIPMENT_ID;
+    if (a.destinationId != b.destinationId)
+        diff |= MU_NVM_DESTINATION_ID;
+    if (a.power != b.power)
+        diff |= MU_NVM_POWER;
+    if (a.routeInfoAdd != b.routeInfoAdd)
+        diff |= MU_NVM_ROUTE_INFO_ADD;
+    if (a.autoReplyRoute != b.autoReplyRoute)
+        diff |= MU_NVM_AUTO_REPLY_ROUTE;
+    if (a.numRouteNodes != b.numRouteNodes || memcmp(a.route, b.route, a.numRouteNodes) != 0)
+        diff |= MU_NVM_ROUTE;
+    return diff;
+}
+
+static void nvmCopy(MU_Modem_NvmConfig &dst, const MU_Modem_NvmConfig &src, uint8_t fields)
+{
+    if (fields & MU_NVM_CHANNEL)
+        dst.channel = src.channel;
+    if (fields & MU_NVM_GROUP_ID)
+        dst.groupId = src.groupId;
+    if (fields & MU_NVM_EQUIPMENT_ID)
+        dst.equipmentId = src.equipmentId;
+    if (fields & MU_NVM_DESTINATION_ID)
+        dst.destinationId = src.destinationId;
+    if (fields & MU_NVM_POWER)
+        dst.power = src.power;
+    if (fields & MU_NVM_ROUTE_INFO_ADD)
+        dst.routeInfoAdd = src.routeInfoAdd;
+    if (fields & MU_NVM_AUTO_REPLY_ROUTE)
+        dst.autoReplyRoute = src.autoReplyRoute;
+    if (fields & MU_NVM_ROUTE)
+    {
+        dst.numRouteNodes = src.numRouteNodes;
+        memcpy(dst.route, src.route, sizeof(dst.route));
     }
-    return ModemParseResult::Parsing;
 }
 
-// --- Callbacks ---
-
-void MU_Modem::onRxDataReceived()
+MU_Modem_Error MU_Modem::m_WriteNvmField(const MU_Modem_NvmConfig &config, uint8_t field, bool saveValue)
 {
-    // Called when parse() returns FinishedDrResponse
-    // 1. Fire Async Callback (Zero Copy)
-    // Pass the _rxBuffer directly.
-    // Note: This buffer is volatile and will be overwritten by the next modem activity.
-    if (m_pCallback && !m_blockAsyncCallback)
+    switch (field)
     {
-        MU_Modem_Event ev(MU_Modem_Error::Ok, MU_Modem_Response::DataReceived, m_lastRxRSSI);
-        ev.pPayload = _rxBuffer;
-        ev.payloadLen = m_drMessageLen;
-        ev.pRouteNodes = m_drRouteInfo;
-        ev.numRouteNodes = m_drNumRouteNodes;
-        m_pCallback(ev);
+    case MU_NVM_CHANNEL:
+        return SetChannel(config.channel, saveValue);
+    case MU_NVM_GROUP_ID:
+        return SetGroupID(config.groupId, saveValue);
+    case MU_NVM_EQUIPMENT_ID:
+        return SetEquipmentID(config.equipmentId, saveValue);
+    case MU_NVM_DESTINATION_ID:
+        return SetDestinationID(config.destinationId, saveValue);
+    case MU_NVM_POWER:
+        return SetPower(config.power, saveValue);
+    case MU_NVM_ROUTE_INFO_ADD:
+        return SetRouteInfoAddMode(config.routeInfoAdd, saveValue);
+    case MU_NVM_AUTO_REPLY_ROUTE:
+        return SetAutoReplyRoute(config.autoReplyRoute, saveValue);
+    case MU_NVM_ROUTE:
+        if (config.numRouteNodes == 0)
+            return ClearRouteInfo(saveValue);
+        return SetRouteInfo(config.route, config.numRouteNodes, saveValue);
+    default:
+        return MU_Modem_Error::InvalidArg;
     }
+}
 
-    // 2. Legacy Support (Copy if buffer provided)
-    if (m_pLegacyBuffer != nullptr && m_legacyBufferSize >= m_drMessageLen)
+void MU_Modem::m_NoteConfigWrite(uint8_t field, bool saveValue)
+{
+    if (saveValue)
     {
-        memcpy(m_pLegacyBuffer, _rxBuffer, m_drMessageLen);
-        // Ensure null termination if there is enough space
-        if (m_legacyBufferSize > m_drMessageLen)
-        {
-            m_pLegacyBuffer[m_drMessageLen] = '\0';
-        }
-        m_drMessagePresent = true;
+        // NVM changed outside CommitConfig(): the reference no longer holds for this field
+        m_nvmVolatileMask &= (uint8_t)~field;
+        m_nvmSnapshotMask &= (uint8_t)~field;
+    }
+    else
+    {
+        m_nvmVolatileMask |= field;
     }
 }
 
-void MU_Modem::onCommandComplete(ModemError result)
+MU_Modem_Error MU_Modem::BeginConfigStage()
 {
-    // Called by Base when a command (async or sync) finishes
-    if (m_pCallback)
+    m_nvmStagedMask = 0;
+    m_nvmSnapshotMask = 0;
+
+    MU_Modem_NvmConfig &snapshot = m_nvmSnapshot;
+    MU_Modem_Error err = GetChannel(&snapshot.channel);
+    if (err == MU_Modem_Error::Ok)
+        err = GetGroupID(&snapshot.groupId);
+    if (err == MU_Modem_Error::Ok)
+        err = GetEquipmentID(&snapshot.equipmentId);
+    if (err == MU_Modem_Error::Ok)
+        err = GetDestinationID(&snapshot.destinationId);
+    if (err == MU_Modem_Error::Ok)
+        err = GetPower(&snapshot.power);
+    if (err == MU_Modem_Error::Ok)
+        err = GetRouteInfoAddMode(&snapshot.routeInfoAdd);
+    if (err == MU_Modem_Error::Ok)
+        err = GetAutoReplyRoute(&snapshot.autoReplyRoute);
+    if (err == MU_Modem_Error::Ok)
     {
-        MU_Modem_Event ev(result, MU_Modem_Response::GenericResponse);
+        memset(snapshot.route, 0, sizeof(snapshot.route));
+        err = GetRouteInfo(snapshot.route, sizeof(snapshot.route), &snapshot.numRouteNodes);
+    }
+    // The modem reports its current values: they are NVM's only for fields not changed volatile since the last reset
+    if (err == MU_Modem_Error::Ok)
+        m_nvmSnapshotMask = MU_NVM_ALL & (uint8_t)~m_nvmVolatileMask;
+    return err;
+}
 
-        const uint8_t *rxBuf = getRxBuffer();
-        uint16_t rxLen = getRxIndex();
+MU_Modem_Error MU_Modem::StageConfig(const MU_Modem_NvmConfig &config, uint8_t fields)
+{
+    if ((fields & MU_NVM_ROUTE) && config.numRouteNodes > MU_MAX_ROUTE_NODES)
+        return MU_Modem_Error::InvalidArg;
 
-        // Check if response is an error (*ER=XX)
-        bool isErrorResp = (rxLen >= MU_ERROR_RESPONSE_PREFIX_LEN + 2 && strncmp((const char *)rxBuf, MU_ERROR_RESPONSE_PREFIX, MU_ERROR_RESPONSE_PREFIX_LEN) == 0);
-        if (isErrorResp)
-        {
-            uint32_t errCode;
-            if (parseHex(rxBuf + MU_ERROR_RESPONSE_PREFIX_LEN, 2, &errCode))
-            {
-                ev.value = (int32_t)errCode;
-            }
-            if (result == ModemError::Ok)
-            {
-                // If base thought it was OK but it's an error code from modem
-                ev.error = ModemError::Fail;
-            }
-        }
+    for (uint16_t field = 1; field <= MU_NVM_ALL; field <<= 1)
+    {
+        if ((fields & field) == 0)
+            continue;
+        MU_Modem_Error err = m_WriteNvmField(config, (uint8_t)field, false);
+        if (err != MU_Modem_Error::Ok)
+            return err;
+        nvmCopy(m_nvmStaged, config, (uint8_t)field);
+        m_nvmStagedMask |= (uint8_t)field;
+    }
+    return MU_Modem_Error::Ok;
+}
 
-        if (m_asyncExpectedResponse != MU_Modem_Response::Idle)
-        {
-            ev.type = m_asyncExpectedResponse;
+MU_Modem_Error MU_Modem::CommitConfig(MU_Modem_NvmCommitReport *pReport)
+{
+    // Drain once up front so no write in the middle of the commit is refused
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
 
-            if (ev.error == ModemError::Ok)
-            {
-                // Parse specific value based on expected response
-                if (ev.type == MU_Modem_Response::RssiCurrentChannel)
-                {
-                    uint8_t rawRssi;
-                    if (parseResponseHex(rxBuf, rxLen, MU_GET_RSSI_CURRENT_CHANNEL_RESPONSE_PREFIX, 2, (uint32_t *)&rawRssi) == ModemError::Ok)
-                        ev.value = -(int16_t)rawRssi;
-                }
-                else if (ev.type == MU_Modem_Response::SerialNumber)
-                {
-                    const char *pData = strchr((const char *)rxBuf, '=');
-                    if (pData)
-                    {
-                        pData++; // Skip '='
-                        if (isalpha((unsigned char)*pData))
-                            pData++; // Skip 'E' etc.
-                        uint32_t sn;
-                        if (parseHex((const uint8_t *)pData, 8, &sn))
-                            ev.value = (int32_t)sn;
-                    }
-                }
-                else if (ev.type == MU_Modem_Response::RssiAllChannels)
-                {
-                    size_t prefixLen = strlen(MU_GET_RSSI_ALL_CHANNELS_RESPONSE_PREFIX);
-                    if (rxLen >= prefixLen)
-                    {
-                        ev.pPayload = rxBuf + prefixLen;
-                        ev.payloadLen = rxLen - prefixLen;
-                    }
-                }
-                else if (ev.type == MU_Modem_Response::Channel)
-                {
-                    uint8_t ch;
-                    if (parseResponseHex(rxBuf, rxLen, MU_SET_CHANNEL_RESPONSE_PREFIX, 2, (uint32_t *)&ch) == ModemError::Ok)
-                        ev.value = ch;
-                }
-                else if (ev.type == MU_Modem_Response::GroupID)
-                {
-                    uint8_t gi;
-                    if (parseResponseHex(rxBuf, rxLen, MU_SET_GROUP_RESPONSE_PREFIX, 2, (uint32_t *)&gi) == ModemError::Ok)
-                        ev.value = gi;
-                }
-                else if (ev.type == MU_Modem_Response::EquipmentID)
-                {
-                    uint8_t ei;
-                    if (parseResponseHex(rxBuf, rxLen, MU_SET_EQUIPMENT_RESPONSE_PREFIX, 2, (uint32_t *)&ei) == ModemError::Ok)
-                        ev.value = ei;
-                }
-                else if (ev.type == MU_Modem_Response::DestinationID)
-                {
-                    uint8_t di;
-                    if (parseResponseHex(rxBuf, rxLen, MU_SET_DESTINATION_RESPONSE_PREFIX, 2, (uint32_t *)&di) == ModemError::Ok)
-                        ev.value = di;
-                }
-            }
-            m_asyncExpectedResponse = MU_Modem_Response::Idle;
-        }
-        else
-        {
-            // If it was a DataTx command, notify Tx status
-            if (strncmp((const char *)rxBuf, MU_TRANSMISSION_RESPONSE_PREFIX, strlen(MU_TRANSMISSION_RESPONSE_PREFIX)) == 0)
-            {
-                ev.type = (ev.error == ModemError::Ok) ? MU_Modem_Response::TxComplete : MU_Modem_Response::TxFailed;
-            }
-            else if (isErrorResp)
-            {
-                // If it's an error response and no specific async request,
-                // it might be a failure of a simple command or DataTx.
-            }
-        }
+    uint32_t start = millis();
+    MU_Modem_NvmCommitReport report;
+    report.stagedMask = m_nvmStagedMask;
 
-        m_pCallback(ev);
+    // Only fields NVM is known to hold already are skipped
+    uint8_t unchanged = m_nvmSnapshotMask & (uint8_t)~nvmDiff(m_nvmStaged, m_nvmSnapshot);
+    report.skippedMask = m_nvmStagedMask & unchanged;
+    uint8_t dirty = m_nvmStagedMask & (uint8_t)~unchanged;
+
+    MU_Modem_Error err = MU_Modem_Error::Ok;
+    for (uint16_t field = 1; field <= MU_NVM_ALL && err == MU_Modem_Error::Ok; field <<= 1)
+    {
+        if ((dirty & field) == 0)
+            continue;
+        err = m_WriteNvmField(m_nvmStaged, (uint8_t)field, true);
+        if (err == MU_Modem_Error::Ok)
+            report.writtenMask |= (uint8_t)field;
     }
+
+    nvmCopy(m_nvmSnapshot, m_nvmStaged, report.writtenMask);
+    m_nvmSnapshotMask |= report.writtenMask;
+    m_nvmStagedMask &= (uint8_t)~(report.writtenMask | report.skippedMask);
+
+    report.durationMs = millis() - start;
+    SM_DEBUG_PRINTF("CommitConfig: Wrote 0x%02X, skipped 0x%02X in %lu ms.\n", report.writtenMask, report.skippedMask,
+                    (unsigned long)report.durationMs);
+    if (pReport)
+        *pReport = report;
+    return err;
 }
 
 // --- Configuration Wrappers (Synchronous) ---
 
-MU_Modem_Error MU_Modem::SetBaudRate(uint32_t baudRate, bool saveValue)
+uint8_t MU_Modem::m_BaudRateCode(uint32_t baudRate)
 {
-    uint8_t baudCode;
     switch (baudRate)
     {
     case 1200:
-        baudCode = 0x12;
-        break;
+        return 0x12;
     case 2400:
-        baudCode = 0x24;
-        break;
+        return 0x24;
     case 4800:
-        baudCode = 0x48;
-        break;
+        return 0x48;
     case 9600:
-        baudCode = 0x96;
-        break;
+        return 0x96;
     case 19200:
-        baudCode = 0x19;
-        break;
+        return 0x19;
     case 38400:
-        baudCode = 0x38;
-        break;
+        return 0x38;
     case 57600:
-        baudCode = 0x57;
-        break;
+        return 0x57;
     default:
+        return 0;
+    }
+}
+
+MU_Modem_Error MU_Modem::SetBaudRate(uint32_t baudRate, bool saveValue)
+{
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    uint8_t baudCode = m_BaudRateCode(baudRate);
+    if (baudCode == 0)
         return MU_Modem_Error::InvalidArg;
+
+    MU_Modem_Error err = setByteValue(MU_CMD_BAUD_RATE, baudCode, saveValue, MU_SET_BAUD_RATE_RESPONSE_PREFIX, MU_SET_BAUD_RATE_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+        m_baudRate = baudRate;
+    return err;
+}
+
+MU_Modem_Error MU_Modem::m_ProbeModem()
+{
+    // Flush any partial command the modem may have collected at a wrong rate
+    m_pUart->print("\r\n");
+    delay(5);
+    while (m_pUart->available() > 0)
+        m_pUart->read();
+    m_ResetParser();
+
+    char cmd[8];
+    char *p = appendStr(cmd, cmd, MU_CMD_CHANNEL);
+    appendStr(cmd, p, "\r\n");
+    char resp[16];
+    MU_Modem_Error err = SendRawCommand(cmd, resp, sizeof(resp), MU_BAUD_PROBE_TIMEOUT_MS);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+    return (strncmp(resp, MU_SET_CHANNEL_RESPONSE_PREFIX, strlen(MU_SET_CHANNEL_RESPONSE_PREFIX)) == 0) ? MU_Modem_Error::Ok : MU_Modem_Error::Fail;
+}
+
+MU_Modem_Error MU_Modem::m_ScanBaudRate()
+{
+    // Try the factory default first, then every other supported rate
+    if (m_SwitchHostBaud(MU_DEFAULT_BAUDRATE) == MU_Modem_Error::Ok)
+        return MU_Modem_Error::Ok;
+    for (size_t i = 0; i < sizeof(MU_SUPPORTED_BAUD_RATES) / sizeof(MU_SUPPORTED_BAUD_RATES[0]); ++i)
+    {
+        uint32_t rate = MU_SUPPORTED_BAUD_RATES[i];
+        if (rate != MU_DEFAULT_BAUDRATE && m_SwitchHostBaud(rate) == MU_Modem_Error::Ok)
+            return MU_Modem_Error::Ok;
     }
-    return setByteValue(MU_CMD_BAUD_RATE, baudCode, saveValue, MU_SET_BAUD_RATE_RESPONSE_PREFIX, MU_SET_BAUD_RATE_RESPONSE_LEN);
+    SM_DEBUG_PRINTLN("ScanBaudRate: Modem not found at any rate.");
+    return MU_Modem_Error::Timeout;
+}
+
+MU_Modem_Error MU_Modem::m_SwitchHostBaud(uint32_t baudRate)
+{
+    m_pSetHostBaud(baudRate);
+    delay(MU_BAUD_SWITCH_SETTLE_MS);
+    MU_Modem_Error err = m_ProbeModem();
+    if (err == MU_Modem_Error::Ok)
+        m_baudRate = baudRate;
+    return err;
+}
+
+MU_Modem_Error MU_Modem::m_VerifyLink()
+{
+    // A marginal link usually still answers a short command, so compare several long responses
+    uint32_t reference = 0;
+    for (uint8_t i = 0; i < MU_BAUD_VERIFY_ROUNDS; ++i)
+    {
+        uint32_t sn;
+        MU_Modem_Error err = GetSerialNumber(&sn);
+        if (err != MU_Modem_Error::Ok)
+            return err;
+        if (i == 0)
+            reference = sn;
+        else if (sn != reference)
+            return MU_Modem_Error::Fail;
+    }
+    return MU_Modem_Error::Ok;
+}
+
+MU_Modem_Error MU_Modem::m_TryBaudRate(uint32_t baudRate)
+{
+    uint32_t previous = m_baudRate;
+    MU_Modem_Error err = SetBaudRate(baudRate, false);
+    if (err != MU_Modem_Error::Ok)
+        return err;
+
+    // The modem switches right after its response; follow with the host UART
+    m_pSetHostBaud(baudRate);
+    delay(MU_BAUD_SWITCH_SETTLE_MS);
+    err = m_ProbeModem();
+    if (err == MU_Modem_Error::Ok)
+        err = m_VerifyLink();
+    if (err == MU_Modem_Error::Ok)
+        return MU_Modem_Error::Ok;
+
+    SM_DEBUG_PRINTF("TryBaudRate: %lu bps failed verification, reverting.\n", (unsigned long)baudRate);
+    // Ask the modem to go back (best effort, it may not understand us), then find it again
+    SetBaudRate(previous, false);
+    if (m_SwitchHostBaud(previous) != MU_Modem_Error::Ok)
+        m_ScanBaudRate();
+    return MU_Modem_Error::Fail;
 }
 
 MU_Modem_Error MU_Modem::SetChannel(uint8_t channel, bool saveValue)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     uint8_t chMin = (m_frequencyModel == MU_Modem_FrequencyModel::MHz_429) ? MU_CHANNEL_MIN_429 : MU_CHANNEL_MIN_1216;
     uint8_t chMax = (m_frequencyModel == MU_Modem_FrequencyModel::MHz_429) ? MU_CHANNEL_MAX_429 : MU_CHANNEL_MAX_1216;
     if (channel < chMin || channel > chMax)
         return MU_Modem_Error::InvalidArg;
 
     MU_Modem_Error err = setByteValue(MU_CMD_CHANNEL, channel, saveValue, MU_SET_CHANNEL_RESPONSE_PREFIX, MU_SET_CHANNEL_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_CHANNEL, channel);
+        m_NoteConfigWrite(MU_NVM_CHANNEL, saveValue);
+    }
     if (err == MU_Modem_Error::Ok && saveValue)
     {
         SetAddRssiValue(); // Re-enable RSSI after save
@@ -691,80 +3001,172 @@ MU_Modem_Error MU_Modem::SetChannel(uint8_t channel, bool saveValue)
     return err;
 }
 
+MU_Modem_Error MU_Modem::SetChannelAsync(uint8_t channel, MU_Modem_Priority priority)
+{
+    uint8_t chMin = (m_frequencyModel == MU_Modem_FrequencyModel::MHz_429) ? MU_CHANNEL_MIN_429 : MU_CHANNEL_MIN_1216;
+    uint8_t chMax = (m_frequencyModel == MU_Modem_FrequencyModel::MHz_429) ? MU_CHANNEL_MAX_429 : MU_CHANNEL_MAX_1216;
+    if (channel < chMin || channel > chMax)
+        return MU_Modem_Error::InvalidArg;
+
+    char cmdBuf[16];
+    char *p = appendStr(cmdBuf, cmdBuf, MU_CMD_CHANNEL);
+    p = appendHex2(cmdBuf, p, channel);
+    appendStr(cmdBuf, p, "\r\n");
+    MU_Modem_Error err = m_EnqueueSimpleAsync(cmdBuf, priority, MU_Modem_Response::Channel, 1000);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_CHANNEL, false);
+    return err;
+}
+
 MU_Modem_Error MU_Modem::GetChannel(uint8_t *pChannel)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getByteValue(MU_CMD_CHANNEL, pChannel, MU_SET_CHANNEL_RESPONSE_PREFIX, MU_SET_CHANNEL_RESPONSE_LEN);
 }
 
 MU_Modem_Error MU_Modem::SetPower(uint8_t power, bool saveValue)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     if (power != 0x01 && power != 0x10)
         return MU_Modem_Error::InvalidArg;
-    return setByteValue(MU_CMD_POWER, power, saveValue, MU_SET_POWER_RESPONSE_PREFIX, MU_SET_POWER_RESPONSE_LEN);
+    MU_Modem_Error err = setByteValue(MU_CMD_POWER, power, saveValue, MU_SET_POWER_RESPONSE_PREFIX, MU_SET_POWER_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_POWER, power);
+        m_NoteConfigWrite(MU_NVM_POWER, saveValue);
+    }
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetPower(uint8_t *pPower)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getByteValue(MU_CMD_POWER, pPower, MU_SET_POWER_RESPONSE_PREFIX, MU_SET_POWER_RESPONSE_LEN);
 }
 
+MU_Modem_Error MU_Modem::SetPowerAsync(uint8_t power, MU_Modem_Priority priority)
+{
+    if (power != 0x01 && power != 0x10)
+        return MU_Modem_Error::InvalidArg;
+
+    char cmdBuf[16];
+    char *p = appendStr(cmdBuf, cmdBuf, MU_CMD_POWER);
+    p = appendHex2(cmdBuf, p, power);
+    appendStr(cmdBuf, p, "\r\n");
+    MU_Modem_Error err = m_EnqueueSimpleAsync(cmdBuf, priority, MU_Modem_Response::Power, 1000);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_POWER, false);
+    return err;
+}
+
 MU_Modem_Error MU_Modem::SetDestinationID(uint8_t di, bool saveValue)
 {
-    return setByteValue(MU_CMD_DESTINATION, di, saveValue, MU_SET_DESTINATION_RESPONSE_PREFIX, MU_SET_DESTINATION_RESPONSE_LEN);
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    MU_Modem_Error err = setByteValue(MU_CMD_DESTINATION, di, saveValue, MU_SET_DESTINATION_RESPONSE_PREFIX, MU_SET_DESTINATION_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_DESTINATION_ID, di);
+        m_NoteConfigWrite(MU_NVM_DESTINATION_ID, saveValue);
+    }
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetDestinationID(uint8_t *pDI)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getByteValue(MU_CMD_DESTINATION, pDI, MU_SET_DESTINATION_RESPONSE_PREFIX, MU_SET_DESTINATION_RESPONSE_LEN);
 }
 
 MU_Modem_Error MU_Modem::SetEquipmentID(uint8_t ei, bool saveValue)
 {
-    return setByteValue(MU_CMD_EQUIPMENT, ei, saveValue, MU_SET_EQUIPMENT_RESPONSE_PREFIX, MU_SET_EQUIPMENT_RESPONSE_LEN);
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    MU_Modem_Error err = setByteValue(MU_CMD_EQUIPMENT, ei, saveValue, MU_SET_EQUIPMENT_RESPONSE_PREFIX, MU_SET_EQUIPMENT_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_EQUIPMENT_ID, ei);
+        m_NoteConfigWrite(MU_NVM_EQUIPMENT_ID, saveValue);
+    }
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetEquipmentID(uint8_t *pEI)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getByteValue(MU_CMD_EQUIPMENT, pEI, MU_SET_EQUIPMENT_RESPONSE_PREFIX, MU_SET_EQUIPMENT_RESPONSE_LEN);
 }
 
 MU_Modem_Error MU_Modem::SetGroupID(uint8_t gi, bool saveValue)
 {
-    return setByteValue(MU_CMD_GROUP, gi, saveValue, MU_SET_GROUP_RESPONSE_PREFIX, MU_SET_GROUP_RESPONSE_LEN);
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    MU_Modem_Error err = setByteValue(MU_CMD_GROUP, gi, saveValue, MU_SET_GROUP_RESPONSE_PREFIX, MU_SET_GROUP_RESPONSE_LEN);
+    if (err == MU_Modem_Error::Ok)
+    {
+        m_UpdateShadow(MU_SHADOW_GROUP_ID, gi);
+        m_NoteConfigWrite(MU_NVM_GROUP_ID, saveValue);
+    }
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetGroupID(uint8_t *pGI)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getByteValue(MU_CMD_GROUP, pGI, MU_SET_GROUP_RESPONSE_PREFIX, MU_SET_GROUP_RESPONSE_LEN);
 }
 
 MU_Modem_Error MU_Modem::SetRouteInfoAddMode(bool enabled, bool saveValue)
 {
-    return setBoolValue(MU_CMD_ROUTE_INFO_ADD, enabled, saveValue, MU_GET_ROUTE_INFO_ADD_MODE_RESPONSE_PREFIX);
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    MU_Modem_Error err = setBoolValue(MU_CMD_ROUTE_INFO_ADD, enabled, saveValue, MU_GET_ROUTE_INFO_ADD_MODE_RESPONSE_PREFIX);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_ROUTE_INFO_ADD, saveValue);
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetRouteInfoAddMode(bool *pEnabled)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getBoolValue(MU_CMD_ROUTE_INFO_ADD, pEnabled, MU_GET_ROUTE_INFO_ADD_MODE_RESPONSE_PREFIX);
 }
 
 MU_Modem_Error MU_Modem::SetAutoReplyRoute(bool enabled, bool saveValue)
 {
-    return setBoolValue(MU_CMD_USR_ROUTE, enabled, saveValue, MU_GET_USR_ROUTE_RESPONSE_PREFIX);
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
+    MU_Modem_Error err = setBoolValue(MU_CMD_USR_ROUTE, enabled, saveValue, MU_GET_USR_ROUTE_RESPONSE_PREFIX);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_AUTO_REPLY_ROUTE, saveValue);
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetAutoReplyRoute(bool *pEnabled)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return getBoolValue(MU_CMD_USR_ROUTE, pEnabled, MU_GET_USR_ROUTE_RESPONSE_PREFIX);
 }
 
 MU_Modem_Error MU_Modem::SetAddRssiValue()
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return setBoolValue(MU_CMD_ADD_RSSI, true, false, MU_SET_ADD_RSSI_RESPONSE_PREFIX);
 }
 
 MU_Modem_Error MU_Modem::SoftReset()
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     char cmdBuf[8];
     char *p = appendStr(cmdBuf, cmdBuf, MU_CMD_SOFT_RESET);
     appendStr(cmdBuf, p, "\r\n");
@@ -772,11 +3174,16 @@ MU_Modem_Error MU_Modem::SoftReset()
     MU_Modem_Error err = enqueueCommand(cmdBuf, CommandType::Simple, 1000);
     if (err != MU_Modem_Error::Ok)
         return err;
-    return waitForSyncComplete(1000);
+    err = waitForSyncComplete(1000);
+    if (err == MU_Modem_Error::Ok)
+        m_nvmVolatileMask = 0; // The modem reloaded its settings from NVM
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetUserID(uint16_t *pUI)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     char cmd[16];
     char *p = appendStr(cmd, cmd, MU_CMD_USER_ID);
     appendStr(cmd, p, "\r\n");
@@ -800,6 +3207,8 @@ MU_Modem_Error MU_Modem::GetUserID(uint16_t *pUI)
 
 MU_Modem_Error MU_Modem::GetSerialNumber(uint32_t *pSerialNumber)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     if (!pSerialNumber)
         return MU_Modem_Error::InvalidArg;
 
@@ -842,6 +3251,8 @@ MU_Modem_Error MU_Modem::GetSerialNumber(uint32_t *pSerialNumber)
 
 MU_Modem_Error MU_Modem::GetRssiCurrentChannel(int16_t *pRssi)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     uint8_t val;
     MU_Modem_Error err = getByteValue(MU_CMD_RSSI_CURRENT, &val, MU_GET_RSSI_CURRENT_CHANNEL_RESPONSE_PREFIX, MU_GET_RSSI_CURRENT_CHANNEL_RESPONSE_LEN);
     if (err == MU_Modem_Error::Ok)
@@ -853,15 +3264,16 @@ MU_Modem_Error MU_Modem::GetRssiCurrentChannel(int16_t *pRssi)
 
 MU_Modem_Error MU_Modem::GetRssiCurrentChannelAsync()
 {
-    m_asyncExpectedResponse = MU_Modem_Response::RssiCurrentChannel;
     char cmdBuf[8];
     char *p = appendStr(cmdBuf, cmdBuf, MU_CMD_RSSI_CURRENT);
     appendStr(cmdBuf, p, "\r\n");
-    return enqueueCommand(cmdBuf, CommandType::Simple, 1000);
+    return m_EnqueueSimpleAsync(cmdBuf, MU_Modem_Priority::Diagnostic, MU_Modem_Response::RssiCurrentChannel, 1000);
 }
 
 MU_Modem_Error MU_Modem::GetAllChannelsRssi(int16_t *pRssiBuffer, size_t bufferSize, uint8_t *pNumRssiValues)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     if (!pRssiBuffer || !pNumRssiValues)
         return MU_Modem_Error::InvalidArg;
     *pNumRssiValues = 0;
@@ -909,17 +3321,18 @@ MU_Modem_Error MU_Modem::GetAllChannelsRssi(int16_t *pRssiBuffer, size_t bufferS
 
 MU_Modem_Error MU_Modem::GetAllChannelsRssiAsync()
 {
-    m_asyncExpectedResponse = MU_Modem_Response::RssiAllChannels;
     char cmdBuf[8];
     char *p = appendStr(cmdBuf, cmdBuf, MU_CMD_RSSI_ALL);
     appendStr(cmdBuf, p, "\r\n");
-    return enqueueCommand(cmdBuf, CommandType::Simple, 20000);
+    return m_EnqueueSimpleAsync(cmdBuf, MU_Modem_Priority::Diagnostic, MU_Modem_Response::RssiAllChannels, 20000);
 }
 
 MU_Modem_Error MU_Modem::SetRouteInfo(const uint8_t *pRouteInfo, uint8_t numNodes, bool saveValue)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     // Need to build hex string
-    if (numNodes == 0 || numNodes > 11)
+    if (numNodes == 0 || numNodes > MU_MAX_ROUTE_NODES)
         return MU_Modem_Error::InvalidArg;
 
     char cmdBuffer[128]; // Stack heavy, but Sync command
@@ -937,11 +3350,16 @@ MU_Modem_Error MU_Modem::SetRouteInfo(const uint8_t *pRouteInfo, uint8_t numNode
     MU_Modem_Error err = enqueueCommand(cmdBuffer, saveValue ? CommandType::NvmSave : CommandType::Simple, 1500);
     if (err != MU_Modem_Error::Ok)
         return err;
-    return waitForSyncComplete(1500);
+    err = waitForSyncComplete(1500);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_ROUTE, saveValue);
+    return err;
 }
 
 MU_Modem_Error MU_Modem::ClearRouteInfo(bool saveValue)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     char cmdBuffer[32];
     char *p = appendStr(cmdBuffer, cmdBuffer, MU_CMD_ROUTE);
     p = appendStr(cmdBuffer, p, "NA");
@@ -951,11 +3369,16 @@ MU_Modem_Error MU_Modem::ClearRouteInfo(bool saveValue)
     MU_Modem_Error err = enqueueCommand(cmdBuffer, saveValue ? CommandType::NvmSave : CommandType::Simple, 1500);
     if (err != MU_Modem_Error::Ok)
         return err;
-    return waitForSyncComplete(1500);
+    err = waitForSyncComplete(1500);
+    if (err == MU_Modem_Error::Ok)
+        m_NoteConfigWrite(MU_NVM_ROUTE, saveValue);
+    return err;
 }
 
 MU_Modem_Error MU_Modem::GetRouteInfo(uint8_t *pRouteInfoBuffer, size_t bufferSize, uint8_t *pNumNodes)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     if (!pRouteInfoBuffer || !pNumNodes)
         return MU_Modem_Error::InvalidArg;
     *pNumNodes = 0;
@@ -1029,11 +3452,19 @@ MU_Modem_Error MU_Modem::CheckCarrierSense()
 
 MU_Modem_Error MU_Modem::SendRawCommand(const char *command, char *responseBuffer, size_t bufferSize, uint32_t timeoutMs)
 {
+    if (!m_WaitAsyncIdle())
+        return MU_Modem_Error::Busy;
     return sendRawCommand(command, responseBuffer, bufferSize, timeoutMs);
 }
 
 // --- Legacy Packet Accessors ---
 
+void MU_Modem::DeletePacket()
+{
+    m_drMessagePresent = false;
+    m_UpdateRxThrottle();
+}
+
 MU_Modem_Error MU_Modem::GetPacket(const uint8_t **ppData, uint8_t *len)
 {
     if (m_drMessagePresent)
@@ -1048,7 +3479,7 @@ MU_Modem_Error MU_Modem::GetPacket(const uint8_t **ppData, uint8_t *len)
             // Note: This is volatile and may be overwritten by next command
             *ppData = _rxBuffer;
         }
-        *len = m_drMessageLen;
+        *len = m_legacyPacketLen;
         return MU_Modem_Error::Ok;
     }
     return MU_Modem_Error::Fail;
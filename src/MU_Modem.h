@@ -19,6 +19,8 @@
 #pragma once
 #include <Arduino.h>
 #include "common/SerialModemBase.h"
+#include "MU_Compressor.h"
+#include "MU_AesCcm.h"
 
 /**
  * @brief Default baud rate for the MU modem.
@@ -35,6 +37,197 @@ static constexpr uint8_t MU_CHANNEL_MAX_1216 = 0x14; //!< Maximum channel number
 
 static constexpr uint8_t MU_MAX_PAYLOAD_LEN = 255;      //!< Maximum payload and route node constants.
 static constexpr uint8_t MU_MAX_ROUTE_NODES_IN_DR = 12; //!< Max route nodes in a *DR response (src + 10 relays + dest)
+static constexpr uint8_t MU_MAX_ROUTE_NODES = 11;       //!< Max IDs in @RT route information (10 relays + dest)
+
+/**
+ * @brief Largest per-frame overhead of the encryption framing (header plus a 16-byte tag).
+ * With a tag of N bytes the overhead is MU_AEAD_HEADER_MAX_LEN + N.
+ */
+static constexpr uint8_t MU_AEAD_HEADER_MAX_LEN = 7;
+static constexpr uint8_t MU_AEAD_MAX_OVERHEAD = MU_AEAD_HEADER_MAX_LEN + 16;
+
+/**
+ * @brief Bytes by which the protocol layers' frame buffers are smaller than a full frame.
+ * The layers size their frames to MU_Modem::GetMaxPayloadLen() at runtime, so encryption and
+ * the link tag need no reserve; a non-zero value only trims the buffers and caps every layer frame
+ * at MU_LAYER_PAYLOAD_LEN bytes.
+ */
+#ifndef MU_PAYLOAD_RESERVE
+#define MU_PAYLOAD_RESERVE 0
+#endif
+static constexpr uint8_t MU_LAYER_PAYLOAD_LEN = MU_MAX_PAYLOAD_LEN - MU_PAYLOAD_RESERVE; //!< Largest frame the layers build
+
+/**
+ * @brief Air time of one payload byte [us]. The 1216 MHz model runs at twice the rate of the 429 MHz model.
+ */
+static constexpr uint16_t MU_AIRTIME_BYTE_US_429 = 2080;
+static constexpr uint16_t MU_AIRTIME_BYTE_US_1216 = 1040;
+
+/**
+ * @brief Fixed air time of every frame in byte times (preamble, sync word, header, CRC).
+ * Can be overridden with a build flag to match a measurement.
+ */
+#ifndef MU_AIRTIME_OVERHEAD_BYTES
+#define MU_AIRTIME_OVERHEAD_BYTES 12
+#endif
+
+/**
+ * @brief Number of neighbors in the link quality table (at least 1).
+ */
+#ifndef MU_NEIGHBOR_TABLE_SIZE
+#if defined(__AVR__)
+#define MU_NEIGHBOR_TABLE_SIZE 4
+#else
+#define MU_NEIGHBOR_TABLE_SIZE 16
+#endif
+#endif
+
+/**
+ * @brief Keeps a 256-byte index from node ID to table entry, so a neighbor lookup is a direct index.
+ * Set it to 0 to save the RAM; a lookup then scans the MU_NEIGHBOR_TABLE_SIZE entries.
+ */
+#ifndef MU_NEIGHBOR_DIRECT_INDEX
+#if defined(__AVR__)
+#define MU_NEIGHBOR_DIRECT_INDEX 0
+#else
+#define MU_NEIGHBOR_DIRECT_INDEX 1
+#endif
+#endif
+
+/**
+ * @brief Entries of the duplicate suppression cache (power of two).
+ */
+#ifndef MU_DEDUP_CACHE_SIZE
+#if defined(__AVR__)
+#define MU_DEDUP_CACHE_SIZE 8
+#else
+#define MU_DEDUP_CACHE_SIZE 32
+#endif
+#endif
+
+/**
+ * @brief Number of peers whose replay window is tracked while encryption is enabled.
+ */
+#ifndef MU_AEAD_MAX_PEERS
+#define MU_AEAD_MAX_PEERS 8
+#endif
+
+/**
+ * @brief Compiles in the payload codec buffers used by compression, encryption and the link tag
+ * (MU_TX_PIPELINE_DEPTH + 3 buffers of MU_MAX_PAYLOAD_LEN bytes).
+ * With 0, SetCompression() and SetLinkTag() have no effect and SetEncryption() returns MU_Modem_Error::InvalidArg.
+ */
+#ifndef MU_ENABLE_PAYLOAD_CODEC
+#if defined(__AVR__)
+#define MU_ENABLE_PAYLOAD_CODEC 0
+#else
+#define MU_ENABLE_PAYLOAD_CODEC 1
+#endif
+#endif
+
+/**
+ * @brief Compiles in the buffers TransmitDataV()/TransmitDataVAsync() gather their segments into
+ * (MU_TX_PIPELINE_DEPTH + 1 buffers of MU_MAX_PAYLOAD_LEN bytes, shared with the payload codec).
+ * With 0 both return MU_Modem_Error::InvalidArg.
+ */
+#ifndef MU_ENABLE_TX_GATHER
+#if defined(__AVR__)
+#define MU_ENABLE_TX_GATHER 0
+#else
+#define MU_ENABLE_TX_GATHER 1
+#endif
+#endif
+
+/**
+ * @brief Payload bytes collected before they are passed to the receive sink (see SetRxSink()).
+ */
+#ifndef MU_RX_SINK_CHUNK_LEN
+#define MU_RX_SINK_CHUNK_LEN 16
+#endif
+
+/**
+ * @brief Longest time a synchronous command waits for queued commands already handed to the modem [ms].
+ * Meanwhile Work() is pumped and nothing new is dispatched; if they have not finished by then,
+ * the synchronous command returns MU_Modem_Error::Busy.
+ */
+#ifndef MU_SYNC_DRAIN_TIMEOUT_MS
+#define MU_SYNC_DRAIN_TIMEOUT_MS 3000
+#endif
+
+/**
+ * @brief Number of receive filters (see SetRxFilters()).
+ */
+#ifndef MU_RX_FILTER_COUNT
+#define MU_RX_FILTER_COUNT 4
+#endif
+
+/**
+ * @brief Depth of each per-priority command queue (number of pending commands per class).
+ * Can be overridden with a build flag (e.g. -D MU_CMD_QUEUE_DEPTH=8).
+ */
+#ifndef MU_CMD_QUEUE_DEPTH
+#if defined(__AVR__)
+#define MU_CMD_QUEUE_DEPTH 2
+#else
+#define MU_CMD_QUEUE_DEPTH 4
+#endif
+#endif
+
+/**
+ * @brief Number of times a non-empty class may be passed over by higher priority classes
+ * before it is served regardless of priority (starvation protection).
+ */
+#ifndef MU_QUEUE_STARVATION_LIMIT
+#define MU_QUEUE_STARVATION_LIMIT 8
+#endif
+
+/**
+ * @brief Maximum number of data transmissions handed to SerialModemBase at once.
+ * A value of 2 or more keeps the modem's continuous transmission mode running.
+ */
+#ifndef MU_TX_PIPELINE_DEPTH
+#define MU_TX_PIPELINE_DEPTH 2
+#endif
+
+/**
+ * @brief Number of accepted frames whose LBT result (*IR=01) can be awaited at the same time.
+ * Frames are held in their queue while every place is taken by a frame in flight or in its LBT window.
+ */
+#ifndef MU_TX_VERDICT_DEPTH
+#if defined(__AVR__)
+#define MU_TX_VERDICT_DEPTH 2
+#else
+#define MU_TX_VERDICT_DEPTH 4
+#endif
+#endif
+
+/**
+ * @brief Extra slots of each priority queue for frames requeued after an LBT failure.
+ * The default guarantees room for every frame in flight or awaiting its LBT result; with fewer slots
+ * (down to 0) a retry that finds its queue full is reported as TxFailed instead.
+ */
+#ifndef MU_QUEUE_RETRY_RESERVE
+#if defined(__AVR__)
+#define MU_QUEUE_RETRY_RESERVE 1
+#else
+#define MU_QUEUE_RETRY_RESERVE (MU_TX_VERDICT_DEPTH + MU_TX_PIPELINE_DEPTH)
+#endif
+#endif
+
+/**
+ * @brief Delay from the *DT response to the start of the transmission (carrier sense) [us].
+ * Used by EstimateAirTime() for transmitted frames.
+ */
+#ifndef MU_TX_START_DELAY_US
+#define MU_TX_START_DELAY_US 5000
+#endif
+
+/**
+ * @brief Maximum number of payload bytes waiting in one priority class (byte credits).
+ */
+#ifndef MU_TX_QUEUE_MAX_BYTES
+#define MU_TX_QUEUE_MAX_BYTES 1024
+#endif
 
 /**
  * @enum MU_Modem_Response
@@ -47,6 +240,7 @@ enum class MU_Modem_Response
     Timeout,      //!< No response received within the timeout period.
     TxComplete,   //!< Transmission accepted (*DT response received)
     TxFailed,     //!< Transmission failed (LBT Error or NACK)
+    TxWritable,   //!< Queue capacity returned after a rejected enqueue (value = priority class index).
     DataReceived, //!< Data packet received
     // Serial command responses
     ShowMode,           //!< Response indicating the modem's mode.
@@ -59,9 +253,20 @@ enum class MU_Modem_Response
     GroupID,            //!< Response related to Group ID ("*GI...").
     EquipmentID,        //!< Response related to Equipment ID ("*EI...").
     DestinationID,      //!< Response related to Destination ID ("*DI...").
+    Power,              //!< Response related to transmission power ("*PW...").
     GenericResponse,    //!< Generic response received from SendRawCommand.
 };
 
+/**
+ * @struct MU_Modem_Segment
+ * @brief One piece of a frame passed to TransmitDataV()/TransmitDataVAsync().
+ */
+struct MU_Modem_Segment
+{
+    const uint8_t *pData; //!< Segment bytes (may be null if len is 0).
+    uint8_t len;          //!< Segment length in bytes.
+};
+
 /**
  * @struct MU_Modem_Event
  * @brief Structure containing information about an asynchronous event or response.
@@ -75,18 +280,20 @@ struct MU_Modem_Event
     uint16_t payloadLen;        //!< Length of payload.
     const uint8_t *pRouteNodes; //!< Pointer to route info (for DataReceived).
     uint8_t numRouteNodes;      //!< Number of route nodes.
+    uint32_t timestampUs;       //!< micros() at the '*' of the modem's response (*DR/*DS/*DC, or *DT for TxComplete/TxFailed), 0 if none.
+    uint8_t wireLen;            //!< Length of the frame on air, codec overhead included (DataReceived, TxComplete/TxFailed).
 
     // --- Constructors ---
     // 1. Default: Initialize everything to zero/null for safety
-    MU_Modem_Event() : error(ModemError::Ok), type(MU_Modem_Response::Idle), value(0), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0) {}
+    MU_Modem_Event() : error(ModemError::Ok), type(MU_Modem_Response::Idle), value(0), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0), timestampUs(0), wireLen(0) {}
 
     // 2. Helper for simple status events
     MU_Modem_Event(ModemError err, MU_Modem_Response t)
-        : error(err), type(t), value(0), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0) {}
+        : error(err), type(t), value(0), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0), timestampUs(0), wireLen(0) {}
 
     // 3. Helper for events with a value (RSSI, Channel, etc.)
     MU_Modem_Event(ModemError err, MU_Modem_Response t, int32_t val)
-        : error(err), type(t), value(val), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0) {}
+        : error(err), type(t), value(val), pPayload(nullptr), payloadLen(0), pRouteNodes(nullptr), numRouteNodes(0), timestampUs(0), wireLen(0) {}
 };
 
 /**
@@ -105,6 +312,247 @@ enum class MU_Modem_FrequencyModel
     MHz_1216 //!< 1216 MHz model
 };
 
+/**
+ * @enum MU_Modem_Priority
+ * @brief Priority classes of the driver's command queue.
+ * Queued commands are dispatched highest class first. A command already handed to the modem is never preempted.
+ */
+enum class MU_Modem_Priority : uint8_t
+{
+    UrgentTx,   //!< Latency critical data transmission (e.g. alarms).
+    NormalTx,   //!< Regular data transmission (default for TransmitDataAsync).
+    Config,     //!< Asynchronous configuration commands (SetChannelAsync etc.).
+    Diagnostic, //!< Diagnostics such as RSSI measurements and channel scans.
+};
+
+static constexpr uint8_t MU_PRIORITY_CLASS_COUNT = 4; //!< Number of MU_Modem_Priority classes.
+
+/**
+ * @struct MU_Modem_QueueStats
+ * @brief Queue depth and latency metrics of one priority class.
+ */
+struct MU_Modem_QueueStats
+{
+    uint8_t depth;       //!< Number of commands currently waiting in the queue.
+    uint8_t maxDepth;    //!< Highest depth observed since the last reset.
+    uint32_t enqueued;   //!< Number of commands accepted into the queue.
+    uint32_t dispatched; //!< Number of commands handed to the modem.
+    uint32_t rejected;   //!< Number of commands rejected because the queue was full.
+    uint32_t maxWaitMs;  //!< Longest time a command waited in the queue before dispatch [ms].
+};
+
+/**
+ * @struct MU_Modem_RetryPolicy
+ * @brief Retransmission policy for queued frames that fail LBT (*IR=01).
+ * With maxAttempts > 1 the driver keeps a failed frame queued and resends it after a randomized
+ * exponential backoff driven from Work(). TxComplete is then reported after the LBT window has
+ * passed, and TxFailed only once the attempt budget is used up. A retried frame goes before the
+ * frames still queued, but one pipelined behind it may already have been sent, so order is not kept.
+ */
+struct MU_Modem_RetryPolicy
+{
+    uint8_t maxAttempts = 1;        //!< Transmission attempts per frame including the first (1 = no retry).
+    uint16_t baseBackoffMs = 20;    //!< Backoff before the first retry [ms], doubled per attempt.
+    uint16_t maxBackoffMs = 1000;   //!< Upper bound of the backoff [ms].
+    bool carrierSenseCheck = false; //!< Check the channel with @CS before each retry (a busy result only defers it).
+};
+
+/**
+ * @struct MU_Modem_RetryStats
+ * @brief Counters of the retransmission scheduler.
+ */
+struct MU_Modem_RetryStats
+{
+    uint32_t framesDelivered = 0;   //!< Frames finally reported as TxComplete.
+    uint32_t framesDropped = 0;     //!< Frames given up after the attempt budget.
+    uint32_t attemptsDelivered = 0; //!< Sum of attempts of all delivered frames (divide by framesDelivered for the average).
+    uint8_t maxAttempts = 0;        //!< Highest number of attempts a delivered frame needed.
+    uint32_t lbtFailures = 0;       //!< LBT failures (*IR=01) of frames under retry control.
+    uint32_t carrierBusy = 0;       //!< Retries deferred because @CS reported a busy channel.
+};
+
+/**
+ * @struct MU_Modem_AirtimePolicy
+ * @brief Transmit time limit enforced on data transmissions (e.g. a duty cycle regulation).
+ * Frames are scheduled by a token bucket holding at most burstMs of air time and refilled at
+ * (limitMs - burstMs) per windowMs, so no window of windowMs ever contains more than limitMs
+ * of transmission. A larger burst allows longer bursts at the cost of long-run throughput.
+ */
+struct MU_Modem_AirtimePolicy
+{
+    uint32_t limitMs = 0;        //!< Maximum transmit time per window [ms] (0 = no limit).
+    uint32_t windowMs = 3600000; //!< Length of the rolling window [ms], at most one day.
+    uint32_t burstMs = 0;        //!< Transmit time that may be used back-to-back [ms]. Must be less than limitMs.
+};
+
+/**
+ * @struct MU_Modem_AirtimeStats
+ * @brief Counters of the airtime budget.
+ */
+struct MU_Modem_AirtimeStats
+{
+    uint32_t airtimeMs = 0; //!< Estimated total transmit time of data frames [ms].
+    uint32_t frames = 0;    //!< Data frames charged to the budget.
+    uint32_t holds = 0;     //!< Number of times a queued frame was held back for lack of budget.
+    uint32_t rejected = 0;  //!< Synchronous transmissions refused for lack of budget.
+};
+
+/**
+ * @struct MU_Modem_CompressionStats
+ * @brief Counters of the transparent payload compression.
+ */
+struct MU_Modem_CompressionStats
+{
+    uint32_t framesCompressed = 0; //!< Frames sent compressed.
+    uint32_t framesRaw = 0;        //!< Frames sent uncompressed because compression did not save airtime.
+    uint32_t rawBytes = 0;         //!< Payload bytes passed to TransmitData()/TransmitDataAsync().
+    uint32_t wireBytes = 0;        //!< Payload bytes actually sent to the modem.
+    uint32_t rxDecoded = 0;        //!< Compressed frames restored on reception.
+    uint32_t rxErrors = 0;         //!< Received frames dropped because they could not be restored.
+};
+
+/**
+ * @struct MU_Modem_SecurityStats
+ * @brief Counters of the authenticated encryption framing.
+ */
+struct MU_Modem_SecurityStats
+{
+    uint32_t framesEncrypted = 0;  //!< Frames sent encrypted.
+    uint32_t framesDecrypted = 0;  //!< Received frames that passed authentication.
+    uint32_t authFailures = 0;     //!< Received frames dropped because the tag did not match (wrong key, corruption, forgery).
+    uint32_t replays = 0;          //!< Received frames dropped as duplicates or too old for the replay window.
+    uint32_t unsynced = 0;         //!< Frames of an unknown sender dropped while waiting for its full sequence number.
+    uint32_t plaintextDropped = 0; //!< Unencrypted frames dropped while encryption is enabled.
+};
+
+/**
+ * @struct MU_Modem_Neighbor
+ * @brief Link quality of one sender, maintained from every received frame.
+ */
+struct MU_Modem_Neighbor
+{
+    uint8_t id;          //!< Sender ID (link tag / encryption sender, or the originator in the route information).
+    int16_t rssiDbm;     //!< Smoothed RSSI (EWMA, weight 1/8) [dBm].
+    uint32_t packets;    //!< Frames received.
+    uint32_t lost;       //!< Frames missed, inferred from sequence gaps (tagged or encrypted frames only).
+    uint8_t lossPct;     //!< Smoothed loss rate [%].
+    uint32_t lastSeenMs; //!< millis() of the last frame.
+};
+
+/**
+ * @struct MU_Modem_DedupStats
+ * @brief Counters of the duplicate suppression cache.
+ */
+struct MU_Modem_DedupStats
+{
+    uint32_t hits = 0;      //!< Duplicates dropped before the DataReceived event.
+    uint32_t misses = 0;    //!< Frames seen for the first time.
+    uint32_t evictions = 0; //!< Unexpired entries overwritten because their probe run was full.
+};
+
+static constexpr uint8_t MU_RX_FILTER_PREFIX_MAX = 4; //!< Payload bytes a receive filter can match
+
+/**
+ * @enum MU_Modem_RxFilterAction
+ * @brief What happens to a frame matched by a receive filter.
+ */
+enum class MU_Modem_RxFilterAction : uint8_t
+{
+    Accept, //!< Receive the frame as usual.
+    Drop    //!< Skip the frame in the parser.
+};
+
+/**
+ * @struct MU_Modem_RxFilter
+ * @brief One receive filter rule. All of its conditions must hold for a frame to match.
+ */
+struct MU_Modem_RxFilter
+{
+    MU_Modem_RxFilterAction action = MU_Modem_RxFilterAction::Drop; //!< Action for matching frames.
+    uint8_t prefixLen = 0;                                           //!< Bytes of prefix to compare (0 = any payload).
+    uint8_t prefix[MU_RX_FILTER_PREFIX_MAX] = {};                    //!< Bytes the payload starts with (as on air, before decoding).
+    uint8_t minLen = 0;                                              //!< Shortest matching payload.
+    uint8_t maxLen = MU_MAX_PAYLOAD_LEN;                             //!< Longest matching payload.
+    int16_t minRssiDbm = -255;                                       //!< Weakest matching RSSI [dBm]; frames without RSSI (*DR) pass.
+};
+
+/**
+ * @struct MU_Modem_RxFilterStats
+ * @brief Counters of the receive filters.
+ */
+struct MU_Modem_RxFilterStats
+{
+    uint32_t hits[MU_RX_FILTER_COUNT] = {}; //!< Frames decided by each filter.
+    uint32_t defaultHits = 0;               //!< Frames no filter matched.
+    uint32_t dropped = 0;                   //!< Frames skipped in the parser.
+};
+
+/**
+ * @brief Field bits of MU_Modem_ConfigShadow::validMask.
+ */
+static constexpr uint8_t MU_SHADOW_CHANNEL = 0x01;        //!< channel is valid
+static constexpr uint8_t MU_SHADOW_GROUP_ID = 0x02;       //!< groupId is valid
+static constexpr uint8_t MU_SHADOW_EQUIPMENT_ID = 0x04;   //!< equipmentId is valid
+static constexpr uint8_t MU_SHADOW_DESTINATION_ID = 0x08; //!< destinationId is valid
+static constexpr uint8_t MU_SHADOW_POWER = 0x10;          //!< power is valid
+
+/**
+ * @struct MU_Modem_ConfigShadow
+ * @brief Copy of the key modem settings, kept by the driver and used for a warm start.
+ * Store it in memory that survives the host's sleep (e.g. RTC RAM) and pass it to beginWarm().
+ */
+struct MU_Modem_ConfigShadow
+{
+    uint8_t validMask = 0;     //!< Combination of MU_SHADOW_* bits for the fields below that are known.
+    uint8_t channel = 0;       //!< Frequency channel.
+    uint8_t groupId = 0;       //!< Group ID.
+    uint8_t equipmentId = 0;   //!< Equipment ID.
+    uint8_t destinationId = 0; //!< Destination ID.
+    uint8_t power = 0;         //!< Transmission power (0x01 or 0x10).
+};
+
+/**
+ * @brief Field bits of MU_Modem_NvmConfig, used by StageConfig() and CommitConfig().
+ */
+static constexpr uint8_t MU_NVM_CHANNEL = 0x01;          //!< channel
+static constexpr uint8_t MU_NVM_GROUP_ID = 0x02;         //!< groupId
+static constexpr uint8_t MU_NVM_EQUIPMENT_ID = 0x04;     //!< equipmentId
+static constexpr uint8_t MU_NVM_DESTINATION_ID = 0x08;   //!< destinationId
+static constexpr uint8_t MU_NVM_POWER = 0x10;            //!< power
+static constexpr uint8_t MU_NVM_ROUTE_INFO_ADD = 0x20;   //!< routeInfoAdd
+static constexpr uint8_t MU_NVM_AUTO_REPLY_ROUTE = 0x40; //!< autoReplyRoute
+static constexpr uint8_t MU_NVM_ROUTE = 0x80;            //!< route and numRouteNodes
+static constexpr uint8_t MU_NVM_ALL = 0xFF;              //!< All of the above
+
+/**
+ * @struct MU_Modem_NvmConfig
+ * @brief Settings that can be staged and persisted with StageConfig() and CommitConfig().
+ */
+struct MU_Modem_NvmConfig
+{
+    uint8_t channel = 0;                     //!< Frequency channel.
+    uint8_t groupId = 0;                     //!< Group ID.
+    uint8_t equipmentId = 0;                 //!< Equipment ID.
+    uint8_t destinationId = 0;               //!< Destination ID.
+    uint8_t power = 0;                       //!< Transmission power (0x01 or 0x10).
+    bool routeInfoAdd = false;               //!< Route information add mode.
+    bool autoReplyRoute = false;             //!< Auto reply route mode.
+    uint8_t numRouteNodes = 0;               //!< IDs in route, 0 = no route information.
+    uint8_t route[MU_MAX_ROUTE_NODES] = {};  //!< Relay station IDs and destination ID.
+};
+
+/**
+ * @struct MU_Modem_NvmCommitReport
+ * @brief Outcome of CommitConfig().
+ */
+struct MU_Modem_NvmCommitReport
+{
+    uint8_t stagedMask = 0;  //!< MU_NVM_* fields staged when the commit started.
+    uint8_t writtenMask = 0; //!< Fields written to NVM.
+    uint8_t skippedMask = 0; //!< Fields skipped because NVM already holds the staged value.
+    uint32_t durationMs = 0; //!< Time spent in the commit [ms].
+};
+
 /**
  * @enum MU_Modem_ParserState
  * @brief Internal parser state for MU specific responses.
@@ -125,9 +573,209 @@ enum class MU_Modem_ParserState
  */
 typedef void (*MU_Modem_AsyncCallback)(const MU_Modem_Event &event);
 
+/**
+ * @brief Callback function type used to reconfigure the host UART (e.g. `Serial1.updateBaudRate(baudRate)`).
+ * @param baudRate The new baud rate the host UART must use.
+ */
+typedef void (*MU_Modem_HostBaudCallback)(uint32_t baudRate);
+
+class MU_Modem;
+
+/**
+ * @brief First payload byte identifying frames of the driver's protocol layers.
+ * Application frames sent while a layer is attached must not start with one of these values.
+ */
+static constexpr uint8_t MU_PROTO_RELIABLE = 0xD1;  //!< MU_ReliableLink frame
+static constexpr uint8_t MU_PROTO_FRAGMENT = 0xD2;  //!< MU_Fragmenter frame
+static constexpr uint8_t MU_PROTO_FEC = 0xD3;       //!< MU_Fragmenter frame with erasure coding
+static constexpr uint8_t MU_PROTO_AGGREGATE = 0xD4; //!< MU_Aggregator frame
+static constexpr uint8_t MU_PROTO_RELAY = 0xD5;     //!< MU_Relay frame
+static constexpr uint8_t MU_PROTO_BEACON = 0xD6;    //!< MU_Beacon frame
+static constexpr uint8_t MU_PROTO_TDMA = 0xD7;      //!< MU_Tdma sync frame
+static constexpr uint8_t MU_PROTO_HOP = 0xD8;       //!< MU_Hopper sync frame
+static constexpr uint8_t MU_PROTO_CODEC = 0xDC;     //!< Payload transformed by the driver (compression, encryption)
+
+/**
+ * @class MU_Modem_Layer
+ * @brief Base class of optional protocol layers stacked on top of the driver.
+ * An attached layer sees every event before the application callback and is called from Work().
+ */
+class MU_Modem_Layer
+{
+public:
+    virtual ~MU_Modem_Layer() {}
+
+    /**
+     * @brief Offers an event to the layer.
+     * @param modem The driver the event comes from.
+     * @param event The event. TxComplete/TxFailed of queued frames carry the transmitted buffer in pPayload.
+     * @return True if the event belongs to the layer and must not be passed on.
+     */
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) = 0;
+
+    /**
+     * @brief Called at the end of every MU_Modem::Work() for timers.
+     * @param modem The driver.
+     */
+    virtual void OnModemWork(MU_Modem &modem) { (void)modem; }
+
+    /**
+     * @brief Asked before a queued data frame is handed to the modem (TransmitDataAsync() only).
+     * @param modem The driver.
+     * @param wireLen Upper bound of the frame's length on air, codec overhead included.
+     * @param aheadUs Upper bound of the air time of the frames already handed to the modem and not
+     * yet complete [us]; the frame goes on air only after them (see MU_TX_PIPELINE_DEPTH).
+     * @return False to hold the frame in its queue; it is offered again on the next Work().
+     */
+    virtual bool OnModemTxGate(MU_Modem &modem, uint8_t wireLen, uint32_t aheadUs)
+    {
+        (void)modem;
+        (void)wireLen;
+        (void)aheadUs;
+        return true;
+    }
+
+protected:
+    /**
+     * @brief Passes an event to the layers attached after this one, then to the application callback.
+     * Used by layers that turn one received frame into several events.
+     * @param modem The driver.
+     * @param event The event to deliver.
+     */
+    void EmitEvent(MU_Modem &modem, const MU_Modem_Event &event);
+
+    /**
+     * @brief Gets the largest frame a layer may transmit with the driver's current framing.
+     * @param modem The driver.
+     * @return MU_Modem::GetMaxPayloadLen(), at most MU_LAYER_PAYLOAD_LEN.
+     */
+    static uint8_t GetLayerFrameLen(const MU_Modem &modem);
+
+private:
+    friend class MU_Modem;
+    MU_Modem_Layer *m_pNextLayer = nullptr;
+};
+
+/**
+ * @class MU_Modem_RxSink
+ * @brief Receiver of data frames streamed from the parser (see MU_Modem::SetRxSink()).
+ * Streamed payloads never pass through the driver's receive buffer, so frames of up to
+ * 255 bytes arrive complete even with a small SerialModemBase buffer, and processing can
+ * start before the frame's CRLF. They bypass duplicate suppression, the protocol layers and
+ * the DataReceived event; the sink is not used while the payload codec is on.
+ */
+class MU_Modem_RxSink
+{
+public:
+    virtual ~MU_Modem_RxSink() {}
+
+    /**
+     * @brief Called once the length of a received frame is known, before any payload byte.
+     * @param modem The driver.
+     * @param len Payload length announced by the modem.
+     * @param rssi RSSI of the frame [dBm] (of the previous frame if the modem does not report it up front).
+     * @return True to stream this frame, false to receive it the usual way (DataReceived event).
+     */
+    virtual bool OnRxBegin(MU_Modem &modem, uint8_t len, int16_t rssi) = 0;
+
+    /**
+     * @brief Delivers the next payload bytes, in order.
+     * @param modem The driver.
+     * @param pData Payload bytes (valid only during the call).
+     * @param len Number of bytes, at most MU_RX_SINK_CHUNK_LEN.
+     */
+    virtual void OnRxData(MU_Modem &modem, const uint8_t *pData, uint8_t len) = 0;
+
+    /**
+     * @brief Ends a streamed frame.
+     * @param modem The driver.
+     * @param event DataReceived event without payload: value is the RSSI, payloadLen the total length,
+     * route information and timestamp as usual. error is not Ok if the response was cut off.
+     */
+    virtual void OnRxEnd(MU_Modem &modem, const MU_Modem_Event &event) = 0;
+};
+
+/**
+ * @class MU_Modem_FlowControl
+ * @brief Abstraction of the modem's hardware flow control lines (RTS/CTS).
+ * Derive from this class to drive the lines from something other than GPIO (e.g. a host emulator).
+ */
+class MU_Modem_FlowControl
+{
+public:
+    virtual ~MU_Modem_FlowControl() {}
+
+    /**
+     * @brief Reads the modem's RTS output.
+     * @return True while the modem cannot accept more data (RTS HIGH).
+     */
+    virtual bool IsModemBusy() = 0;
+
+    /**
+     * @brief Drives the modem's CTS input.
+     * @param busy True to ask the modem to hold its output (CTS HIGH), false to allow it.
+     */
+    virtual void SetHostBusy(bool busy) = 0;
+};
+
+/**
+ * @class MU_Modem_PinFlowControl
+ * @brief MU_Modem_FlowControl implementation using Arduino GPIO pins.
+ */
+class MU_Modem_PinFlowControl : public MU_Modem_FlowControl
+{
+public:
+    /**
+     * @brief Configures the pins.
+     * @param rtsPin Pin connected to the modem's RTS output, or -1 if not connected.
+     * @param ctsPin Pin connected to the modem's CTS input, or -1 if not connected.
+     */
+    void begin(int8_t rtsPin, int8_t ctsPin)
+    {
+        m_rtsPin = rtsPin;
+        m_ctsPin = ctsPin;
+        if (m_rtsPin >= 0)
+            pinMode(m_rtsPin, INPUT);
+        if (m_ctsPin >= 0)
+        {
+            pinMode(m_ctsPin, OUTPUT);
+            digitalWrite(m_ctsPin, LOW);
+        }
+    }
+
+    bool IsModemBusy() override { return m_rtsPin >= 0 && digitalRead(m_rtsPin) == HIGH; }
+
+    void SetHostBusy(bool busy) override
+    {
+        if (m_ctsPin >= 0)
+            digitalWrite(m_ctsPin, busy ? HIGH : LOW);
+    }
+
+private:
+    int8_t m_rtsPin = -1;
+    int8_t m_ctsPin = -1;
+};
+
+/**
+ * @struct MU_Modem_FlowControlStats
+ * @brief Counters of the hardware flow control.
+ */
+struct MU_Modem_FlowControlStats
+{
+    uint32_t txHolds;       //!< Number of times a data transmission was held because the modem reported busy.
+    uint32_t rxThrottles;   //!< Number of times CTS was asserted to pause the modem's output.
+    uint32_t rxThrottledMs; //!< Total time CTS was asserted [ms].
+};
+
 /**
  * @class MU_Modem
  * @brief Provides an interface to control the MU FSK modem.
+ *
+ * Synchronous methods (setters, getters, TransmitData(), SendRawCommand() and everything built on
+ * them) share the modem with the asynchronous queue. Before sending, they pump Work() until the
+ * queued commands already handed to the modem have finished, without dispatching new ones, and
+ * return MU_Modem_Error::Busy if that takes longer than MU_SYNC_DRAIN_TIMEOUT_MS. Called from a
+ * callback (inside Work()), they cannot wait and return MU_Modem_Error::Busy right away instead.
  */
 class MU_Modem : public SerialModemBase
 {
@@ -141,6 +789,73 @@ public:
      */
     MU_Modem_Error begin(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_AsyncCallback pCallback = nullptr);
 
+    /**
+     * @brief Initializes the modem driver with automatic baud rate detection and upgrade.
+     * Probes the supported rates (1200 - 57600 bps) to find the modem, initializes it like begin(),
+     * then raises the rate to the highest one up to maxBaudRate that passes a link integrity check.
+     * The upgrade is not saved to NVM, so a modem reset falls back to its stored rate.
+     * @param pUart A reference to the Stream object (e.g., Serial1).
+     * @param frequencyModel The frequency model of the modem.
+     * @param pSetHostBaud Callback that reconfigures the host UART to a given rate.
+     * @param pCallback A pointer to the callback function.
+     * @param maxBaudRate Highest rate the host supports (one of the rates supported by SetBaudRate).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::Timeout if the modem was not found.
+     */
+    MU_Modem_Error beginAutoBaud(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_HostBaudCallback pSetHostBaud,
+                                 MU_Modem_AsyncCallback pCallback = nullptr, uint32_t maxBaudRate = 57600);
+
+    /**
+     * @brief Initializes the modem driver without resetting a modem whose state is already known.
+     * Sends a single @SI as liveness probe and compares the settings marked valid in `expected`
+     * with the modem. Only if the modem does not answer or a setting differs, the full begin()
+     * sequence (reset) runs and the settings of `expected` are re-applied (volatile).
+     * Use GetLastInitTimeMs() and WasWarmStart() to see the outcome.
+     * @param pUart A reference to the Stream object (e.g., Serial1).
+     * @param frequencyModel The frequency model of the modem.
+     * @param expected The shadow captured before the host went to sleep (see GetConfigShadow()).
+     * @param pCallback A pointer to the callback function.
+     * @return MU_Modem_Error::Ok on success (warm or cold), or the error of the cold start.
+     */
+    MU_Modem_Error beginWarm(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, const MU_Modem_ConfigShadow &expected,
+                             MU_Modem_AsyncCallback pCallback = nullptr);
+
+    /**
+     * @brief Gets the duration of the last begin(), beginWarm() or beginAutoBaud() call.
+     * @return Initialization time in milliseconds.
+     */
+    uint32_t GetLastInitTimeMs() const { return m_lastInitTimeMs; }
+
+    /**
+     * @brief Checks whether the last beginWarm() could skip the modem reset.
+     * @return True if the warm start succeeded.
+     */
+    bool WasWarmStart() const { return m_lastInitWarm; }
+
+    /**
+     * @brief Gets the driver's shadow of the settings written through this driver since initialization.
+     * @param pShadow Pointer to store the shadow.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pShadow is null.
+     */
+    MU_Modem_Error GetConfigShadow(MU_Modem_ConfigShadow *pShadow) const;
+
+    /**
+     * @brief Reads all shadowed settings from the modem and updates the driver's shadow.
+     * @param pShadow Pointer to store the shadow (may be null).
+     * @return MU_Modem_Error::Ok on success, or an error code on failure.
+     */
+    MU_Modem_Error CaptureConfigShadow(MU_Modem_ConfigShadow *pShadow);
+
+    /**
+     * @brief Gets the UART baud rate last detected or set by the driver.
+     * @return The baud rate, or 0 if unknown (after begin() without SetBaudRate()).
+     */
+    uint32_t GetBaudRate() const { return m_baudRate; }
+
+    /**
+     * @brief Gets the frequency model passed to begin().
+     */
+    MU_Modem_FrequencyModel GetFrequencyModel() const { return m_frequencyModel; }
+
     /**
      * @brief Main processing loop (Delegates to SerialModemBase::update).
      */
@@ -163,6 +878,9 @@ public:
      * @brief Transmits a data packet (Synchronous/Blocking).
      * Queues the command and waits for completion.
      * Checks for LBT error (*IR=01) for a short period after command acceptance.
+     * Like every synchronous command, it first waits for queued commands already handed to the modem
+     * (see MU_SYNC_DRAIN_TIMEOUT_MS) and returns MU_Modem_Error::Busy if they do not finish in time
+     * or if it is called from a callback while commands are in flight.
      * @param pMsg Pointer to the data buffer to transmit.
      * @param len Length of the data in bytes.
      * @param useRouteRegister If true, appends the /R option to use the route register.
@@ -177,9 +895,345 @@ public:
      * @param pMsg Pointer to the data buffer to transmit.
      * @param len Length of the data in bytes.
      * @param useRouteRegister If true, appends the /R option to use the route register.
-     * @return MU_Modem_Error::Ok if command accepted.
+     * @param priority Priority class of the frame. Use MU_Modem_Priority::UrgentTx for alarms
+     * that must not wait behind background diagnostics or configuration.
+     * @return MU_Modem_Error::Ok if command accepted, MU_Modem_Error::Busy if the class queue is full.
+     */
+    MU_Modem_Error TransmitDataAsync(const uint8_t *pMsg, uint8_t len, bool useRouteRegister = false,
+                                     MU_Modem_Priority priority = MU_Modem_Priority::NormalTx);
+
+    /**
+     * @brief Transmits a frame made of several segments (Synchronous/Blocking), e.g. header, payload and trailer.
+     * The segments are gathered straight into the driver's wire buffer, so no contiguous copy is needed.
+     * @param pSegments Array of segments in frame order.
+     * @param numSegments Number of segments.
+     * @param useRouteRegister If true, appends the /R option to use the route register.
+     * @return As TransmitData(), MU_Modem_Error::InvalidArg if the segments add up to more than GetMaxPayloadLen().
      */
-    MU_Modem_Error TransmitDataAsync(const uint8_t *pMsg, uint8_t len, bool useRouteRegister = false);
+    MU_Modem_Error TransmitDataV(const MU_Modem_Segment *pSegments, uint8_t numSegments, bool useRouteRegister = false);
+
+    /**
+     * @brief Transmits a frame made of several segments (Asynchronous/Non-blocking).
+     * The segment array and the data it points to must stay valid until TxComplete/TxFailed, as they
+     * are read when the frame is dispatched and again for each retransmission. The completion event
+     * carries the first non-empty segment as pPayload and the total length as payloadLen.
+     * @param pSegments Array of segments in frame order.
+     * @param numSegments Number of segments.
+     * @param useRouteRegister If true, appends the /R option to use the route register.
+     * @param priority Priority class of the frame.
+     * @return As TransmitDataAsync(), MU_Modem_Error::InvalidArg if the segments add up to more than GetMaxPayloadLen().
+     */
+    MU_Modem_Error TransmitDataVAsync(const MU_Modem_Segment *pSegments, uint8_t numSegments, bool useRouteRegister = false,
+                                      MU_Modem_Priority priority = MU_Modem_Priority::NormalTx);
+
+    /**
+     * @brief Sets the retransmission policy for frames queued with TransmitDataAsync().
+     * @param policy The policy. maxAttempts = 1 disables retransmission (default).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the policy is inconsistent.
+     */
+    MU_Modem_Error SetTxRetryPolicy(const MU_Modem_RetryPolicy &policy);
+
+    /**
+     * @brief Gets the retransmission counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetTxRetryStats(MU_Modem_RetryStats *pStats) const;
+
+    /**
+     * @brief Resets the retransmission counters.
+     */
+    void ResetTxRetryStats();
+
+    // --- Airtime Budget ---
+
+    /**
+     * @brief Limits the transmit time of data frames.
+     * Every frame is charged its air time estimated from the length handed to the modem.
+     * Queued frames wait in their queue until the budget allows them, so throughput follows the
+     * limit without violating it; TransmitData() returns MU_Modem_Error::Busy instead of waiting.
+     * Frames that fail LBT are charged as well. The bucket starts full.
+     * @param policy The policy. limitMs = 0 removes the limit (default).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the policy is inconsistent
+     * or the burst cannot hold a frame of MU_MAX_PAYLOAD_LEN bytes.
+     */
+    MU_Modem_Error SetAirtimePolicy(const MU_Modem_AirtimePolicy &policy);
+
+    /**
+     * @brief Estimates the air time of a frame.
+     * @param len Payload length as handed to the modem.
+     * @return Air time [us].
+     */
+    uint32_t GetFrameAirtimeUs(uint8_t len) const;
+
+    /**
+     * @brief Gets the transmit time that can be used right now.
+     * @return Remaining budget [us], or 0xFFFFFFFF without a limit.
+     */
+    uint32_t GetAirtimeAvailableUs();
+
+    /**
+     * @brief Gets the time until a frame of the given payload length fits into the budget.
+     * @param len Payload length passed to TransmitDataAsync().
+     * @return Wait time [ms] (0 = can be sent now).
+     */
+    uint32_t GetAirtimeWaitMs(uint8_t len);
+
+    /**
+     * @brief Gets the airtime counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetAirtimeStats(MU_Modem_AirtimeStats *pStats) const;
+
+    /**
+     * @brief Resets the airtime counters.
+     */
+    void ResetAirtimeStats();
+
+    // --- Payload Compression ---
+
+    /**
+     * @brief Enables transparent LZ compression of transmitted payloads.
+     * Frames are compressed when handed to the modem and restored before the DataReceived
+     * event, so both ends must enable it with the same dictionary. Payloads that do not shrink
+     * are sent unchanged. While enabled, a payload starting with MU_PROTO_CODEC is wrapped
+     * and may be at most MU_MAX_PAYLOAD_LEN - 2 bytes long.
+     * @param enable True to compress outgoing frames. Compressed frames are always restored.
+     * @param pDictionary Optional static dictionary of typical content (e.g. JSON keys). Not copied.
+     * @param dictionaryLen Length of the dictionary; the last MU_COMPRESS_MAX_DISTANCE bytes are used.
+     */
+    void SetCompression(bool enable, const uint8_t *pDictionary = nullptr, uint16_t dictionaryLen = 0);
+
+    /**
+     * @brief Gets the compression counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetCompressionStats(MU_Modem_CompressionStats *pStats) const;
+
+    /**
+     * @brief Resets the compression counters.
+     */
+    void ResetCompressionStats() { m_compressStats = MU_Modem_CompressionStats(); }
+
+    // --- Authenticated Encryption ---
+
+    /**
+     * @brief Enables AES-128-CCM encryption and authentication of every frame.
+     * The nonce is derived from the sender ID and a 32-bit frame counter, so only the sender ID,
+     * 2 bytes of the counter (4 bytes now and then to resynchronize receivers) and the truncated
+     * tag are sent: 5 + tagLen bytes per frame in most frames, MU_AEAD_HEADER_MAX_LEN + tagLen at most.
+     * Frames are encrypted in place while being copied to the wire buffer and decrypted in place
+     * in the receive buffer. Received frames that fail authentication, replays and plaintext
+     * frames are dropped. Applied after compression.
+     *
+     * The counter must never repeat under the same key: persist GetTxCounter() (with some headroom)
+     * and pass it back after a reset. Receivers also reject a counter that went backwards.
+     * @param pKey 16-byte key shared by all nodes, copied into the expanded key schedule. nullptr disables encryption.
+     * @param nodeId ID of this node, unique among the nodes sharing the key.
+     * @param tagLen Authentication tag length: 4, 6, 8, 10, 12, 14 or 16 bytes.
+     * @param txCounter First frame counter value to use.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if tagLen is invalid.
+     */
+    MU_Modem_Error SetEncryption(const uint8_t *pKey, uint8_t nodeId, uint8_t tagLen = 4, uint32_t txCounter = 0);
+
+    /**
+     * @brief Gets the frame counter the next encrypted frame will use.
+     * @return The transmit counter.
+     */
+    uint32_t GetTxCounter() const { return m_aeadTxCounter; }
+
+    /**
+     * @brief Gets the largest payload TransmitData()/TransmitDataAsync() accept with the current framing.
+     * @return Maximum payload length in bytes.
+     */
+    uint8_t GetMaxPayloadLen() const;
+
+    /**
+     * @brief Gets the encryption counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetSecurityStats(MU_Modem_SecurityStats *pStats) const;
+
+    /**
+     * @brief Resets the encryption counters.
+     */
+    void ResetSecurityStats() { m_securityStats = MU_Modem_SecurityStats(); }
+
+    // --- Link Quality Table ---
+
+    /**
+     * @brief Adds a 2-byte link tag (sender ID and sequence number) to every transmitted frame.
+     * Receivers key their neighbor table on the tag and infer losses from sequence gaps.
+     * A frame takes its sequence number when queued and keeps it through LBT retries.
+     * Encrypted frames already carry both and are not tagged again. Without a tag, receivers
+     * can only key on the originator in the route information and do not see losses.
+     * @param enable True to tag outgoing frames. Tagged frames are always understood.
+     * @param nodeId ID of this node (e.g. its equipment ID).
+     */
+    void SetLinkTag(bool enable, uint8_t nodeId);
+
+    /**
+     * @brief Looks up the link quality of a sender in constant time.
+     * @param id Sender ID.
+     * @return The entry, or nullptr if nothing was received from the sender (or it was evicted).
+     */
+    const MU_Modem_Neighbor *GetNeighbor(uint8_t id) const;
+
+    /**
+     * @brief Returns the number of entries in the neighbor table.
+     */
+    uint8_t GetNeighborCount() const { return m_neighborCount; }
+
+    /**
+     * @brief Gets a neighbor table entry by position, for iterating over all neighbors.
+     * @param index Position (0 to GetNeighborCount() - 1).
+     * @return The entry, or nullptr if index is out of range.
+     */
+    const MU_Modem_Neighbor *GetNeighborAt(uint8_t index) const;
+
+    /**
+     * @brief Empties the neighbor table.
+     */
+    void ClearNeighbors();
+
+    // --- Duplicate Suppression ---
+
+    /**
+     * @brief Drops copies of a frame that arrive again within the expiry time (e.g. over several relays).
+     * Frames are identified by their originator (route information, else the link tag sender) and the
+     * link tag, so senders must enable SetLinkTag(); untagged frames pass unchecked. Retransmissions
+     * by the application or a layer get a new tag and are not mistaken for copies; the driver's LBT
+     * retries keep theirs, as a failed attempt never went on air. Encrypted frames need no cache: the replay
+     * window already drops copies.
+     * @param enable True to enable the cache. The cache is cleared either way.
+     * @param expiryMs How long a frame is remembered [ms].
+     */
+    void SetDuplicateFilter(bool enable, uint32_t expiryMs = 2000);
+
+    /**
+     * @brief Gets the duplicate suppression counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetDedupStats(MU_Modem_DedupStats *pStats) const;
+
+    /**
+     * @brief Resets the duplicate suppression counters.
+     */
+    void ResetDedupStats() { m_dedupStats = MU_Modem_DedupStats(); }
+
+    // --- Receive Filters ---
+
+    /**
+     * @brief Installs receive filters evaluated by the parser while a frame arrives.
+     * The first matching filter decides; frames no filter matches get defaultAction. A frame is
+     * decided as soon as its RSSI, length and the longest prefix have been read; dropped frames are
+     * skipped without buffering the rest of the payload, route parsing or events. Prefixes are
+     * compared with the frame as on air, i.e. before decompression or decryption.
+     * @param pFilters Filters in priority order (copied).
+     * @param count Number of filters, 0 to receive every frame.
+     * @param defaultAction Action for frames no filter matches.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if there are more than
+     * MU_RX_FILTER_COUNT filters or one of them is inconsistent.
+     */
+    MU_Modem_Error SetRxFilters(const MU_Modem_RxFilter *pFilters, uint8_t count,
+                                MU_Modem_RxFilterAction defaultAction = MU_Modem_RxFilterAction::Accept);
+
+    /**
+     * @brief Gets the receive filter counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetRxFilterStats(MU_Modem_RxFilterStats *pStats) const;
+
+    /**
+     * @brief Resets the receive filter counters.
+     */
+    void ResetRxFilterStats() { m_rxFilterStats = MU_Modem_RxFilterStats(); }
+
+    // --- Command Queue ---
+
+    /**
+     * @brief Gets the metrics of one priority class of the command queue.
+     * @param priority The priority class.
+     * @param pStats Pointer to store the metrics.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetQueueStats(MU_Modem_Priority priority, MU_Modem_QueueStats *pStats) const;
+
+    /**
+     * @brief Resets the counters and high-water marks of all priority classes.
+     * Commands waiting in the queue are not affected.
+     */
+    void ResetQueueStats();
+
+    // --- Flow Control (Backpressure) ---
+
+    /**
+     * @brief Gets the number of free command slots of a priority class.
+     * @param priority The priority class.
+     * @return Number of commands that can be queued right now.
+     */
+    uint8_t GetTxFreeSlots(MU_Modem_Priority priority = MU_Modem_Priority::NormalTx) const;
+
+    /**
+     * @brief Gets the number of payload bytes that can be queued in a priority class right now.
+     * Returns 0 when the class has no free slot, so a producer may send one frame of up to this size.
+     * @param priority The priority class.
+     * @return Free byte credits of the class.
+     */
+    uint16_t GetTxFreeBytes(MU_Modem_Priority priority = MU_Modem_Priority::NormalTx) const;
+
+    /**
+     * @brief Requests a MU_Modem_Response::TxWritable event once a class has at least minFreeBytes credits.
+     * A notification is also armed automatically whenever an enqueue is rejected with MU_Modem_Error::Busy.
+     * The event is delivered from Work(); its value holds the priority class index.
+     * @param priority The priority class to watch.
+     * @param minFreeBytes Number of free byte credits required (at least one free slot is always required).
+     */
+    void RequestWritableNotification(MU_Modem_Priority priority, uint16_t minFreeBytes = 1);
+
+    /**
+     * @brief Transmits a data packet (Asynchronous), waiting up to timeoutMs for queue capacity.
+     * Work() is pumped while waiting. Must not be called from within the async callback.
+     * @param pMsg Pointer to the data buffer to transmit (must stay valid until TxComplete/TxFailed).
+     * @param len Length of the data in bytes.
+     * @param timeoutMs Maximum time to wait for a free slot.
+     * @param useRouteRegister If true, appends the /R option to use the route register.
+     * @param priority Priority class of the frame.
+     * @return MU_Modem_Error::Ok if queued, MU_Modem_Error::Timeout if no capacity became available in time.
+     */
+    MU_Modem_Error TransmitDataAsyncWait(const uint8_t *pMsg, uint8_t len, uint32_t timeoutMs, bool useRouteRegister = false,
+                                         MU_Modem_Priority priority = MU_Modem_Priority::NormalTx);
+
+    // --- Hardware Flow Control (RTS/CTS) ---
+
+    /**
+     * @brief Enables hardware flow control using GPIO pins.
+     * While RTS reads HIGH (modem buffer full) no further data transmission is handed to the modem.
+     * CTS is driven HIGH while a received packet waits for GetPacket()/DeletePacket() (no async callback registered),
+     * so the next *DR stays in the modem instead of overwriting it. Command responses are held back as well meanwhile.
+     * @param rtsPin Pin connected to the modem's RTS output, or -1 if not connected.
+     * @param ctsPin Pin connected to the modem's CTS input, or -1 if not connected (tie CTS to GND then).
+     */
+    void SetFlowControlPins(int8_t rtsPin, int8_t ctsPin);
+
+    /**
+     * @brief Enables hardware flow control through a user supplied line driver.
+     * @param pFlowControl Pointer to the flow control implementation, or nullptr to disable flow control.
+     * The object must stay valid while it is registered.
+     */
+    void SetFlowControl(MU_Modem_FlowControl *pFlowControl);
+
+    /**
+     * @brief Gets the flow control counters.
+     * @param pStats Pointer to store the counters.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pStats is null.
+     */
+    MU_Modem_Error GetFlowControlStats(MU_Modem_FlowControlStats *pStats) const;
 
     // --- Configuration (Synchronous Wrappers) ---
     // These methods block until the modem responds.
@@ -224,6 +1278,28 @@ public:
      */
     MU_Modem_Error GetPower(uint8_t *pPower);
 
+    // --- Configuration (Asynchronous) ---
+    // These methods queue a volatile (non-NVM) setting in the Config priority class and return immediately.
+
+    /**
+     * @brief Sets the frequency channel (Asynchronous, not saved to NVM).
+     * The result will be delivered via the callback with type MU_Modem_Response::Channel.
+     * @param channel The channel number to set. Valid range depends on the frequency model.
+     * @param priority Queue class of the command. UrgentTx switches ahead of queued data frames.
+     * @return MU_Modem_Error::Ok if the command was successfully queued.
+     */
+    MU_Modem_Error SetChannelAsync(uint8_t channel, MU_Modem_Priority priority = MU_Modem_Priority::Config);
+
+    /**
+     * @brief Sets the transmission power (Asynchronous, not saved to NVM).
+     * The result will be delivered via the callback with type MU_Modem_Response::Power.
+     * @param power The power setting to set (0x01 for 1mW, 0x10 for 10mW).
+     * @param priority Queue class of the command. Use the class of the data frames that must go out
+     * with the new power, so the change is not overtaken by frames queued after it.
+     * @return MU_Modem_Error::Ok if the command was successfully queued.
+     */
+    MU_Modem_Error SetPowerAsync(uint8_t power, MU_Modem_Priority priority = MU_Modem_Priority::Config);
+
     // --- ID Settings ---
 
     /**
@@ -326,6 +1402,41 @@ public:
      */
     MU_Modem_Error ClearRouteInfo(bool saveValue);
 
+    // --- Staged Configuration ---
+    /**
+     * @brief Reads the persistable settings back from the modem as reference for CommitConfig()
+     * and discards staged fields. The modem only reports its current values, so fields changed
+     * volatile since the last reset (after beginWarm(), by a Set*() with saveValue false,
+     * StageConfig(), SetChannelAsync() or SetPowerAsync(), e.g. from MU_Hopper or MU_LinkAdapter)
+     * are not taken as reference; CommitConfig() always writes them. SoftReset() and begin()
+     * make every field eligible again.
+     * @return MU_Modem_Error::Ok on success, or an error code on failure.
+     */
+    MU_Modem_Error BeginConfigStage();
+
+    /**
+     * @brief Applies settings volatile and stages them for the next CommitConfig().
+     * Staging a field again replaces its staged value.
+     * @param config The settings.
+     * @param fields Combination of MU_NVM_* bits selecting the fields of config to apply.
+     * @return MU_Modem_Error::Ok on success, or the error of the first field that failed (later fields are not applied).
+     */
+    MU_Modem_Error StageConfig(const MU_Modem_NvmConfig &config, uint8_t fields);
+
+    /**
+     * @brief Returns the MU_NVM_* fields staged and not yet committed.
+     */
+    uint8_t GetStagedFields() const { return m_nvmStagedMask; }
+
+    /**
+     * @brief Writes the staged fields to NVM, skipping those whose value NVM already holds.
+     * Without a preceding BeginConfigStage() every staged field is written. Committed fields
+     * become the new reference, so a later commit again writes only what changed.
+     * @param pReport Pointer to store the outcome (may be null).
+     * @return MU_Modem_Error::Ok on success, or the error of the first write that failed (the field stays staged).
+     */
+    MU_Modem_Error CommitConfig(MU_Modem_NvmCommitReport *pReport = nullptr);
+
     // --- Info & Status ---
     /**
      * @brief Gets the serial number of the modem.
@@ -426,8 +1537,9 @@ public:
 
     /**
      * @brief Clears the buffered data packet flag (Legacy mode).
+     * With flow control enabled this also lets the modem deliver the next packet.
      */
-    void DeletePacket() { m_drMessagePresent = false; }
+    void DeletePacket();
 
     /**
      * @brief Registers or updates the asynchronous callback function.
@@ -435,6 +1547,50 @@ public:
      */
     void SetAsyncCallback(MU_Modem_AsyncCallback pCallback) { m_pCallback = pCallback; }
 
+    /**
+     * @brief Sets a sink that receives data frames in chunks while they arrive from the modem.
+     * The sink decides per frame in OnRxBegin() whether to stream it. Streamed frames are passed
+     * on as received, so while compression, encryption or the link tag is enabled the sink is not
+     * offered any frame and every frame takes the DataReceived path.
+     * @param pSink The sink, or nullptr to receive every frame through the DataReceived event.
+     */
+    void SetRxSink(MU_Modem_RxSink *pSink) { m_pRxSink = pSink; }
+
+    // --- Protocol Layers ---
+
+    /**
+     * @brief Attaches a protocol layer. Layers see events in the order they were attached.
+     * @param pLayer The layer. It must stay valid while attached.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if pLayer is null.
+     */
+    MU_Modem_Error AttachLayer(MU_Modem_Layer *pLayer);
+
+    /**
+     * @brief Detaches a protocol layer.
+     * @param pLayer The layer to remove.
+     */
+    void DetachLayer(MU_Modem_Layer *pLayer);
+
+    /**
+     * @brief Gets the time the last received data frame started to arrive from the modem.
+     * Taken with micros() when the parser reads the '*' of its *DR, *DS or *DC response, i.e. shortly
+     * after the frame ended on air. The resolution depends on how often Work() is called.
+     * @return micros() at the first byte of the last data frame's response.
+     */
+    uint32_t GetRxStartMicros() const { return m_rxStartUs; }
+
+    /**
+     * @brief Estimates when the frame of an event was on air, from its timestamp and wire length.
+     * A received frame ended on air just before the modem started its *DR response (less the
+     * UART time of the '*'). A transmitted frame starts MU_TX_START_DELAY_US after the *DT
+     * response. The start is the end minus GetFrameAirtimeUs(wireLen).
+     * @param event A DataReceived, TxComplete or TxFailed event.
+     * @param pStartUs Pointer to store the estimated start on air (micros()), or nullptr.
+     * @param pEndUs Pointer to store the estimated end on air (micros()), or nullptr.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the event carries no timestamp.
+     */
+    MU_Modem_Error EstimateAirTime(const MU_Modem_Event &event, uint32_t *pStartUs, uint32_t *pEndUs) const;
+
 protected:
     // SerialModemBase overrides
     virtual ModemParseResult parse() override;
@@ -443,7 +1599,119 @@ protected:
     virtual const char *getLogPrefix() const override { return "[MU Modem] "; }
 
 private:
+    friend class MU_Modem_Layer;
+
+    /**
+     * @brief Codec sequence number of a data frame: the AEAD counter or the link-tag sequence.
+     * Assigned once when the frame is queued, so retries and re-dispatches send it unchanged.
+     */
+    struct TxSeq
+    {
+        uint32_t value; //!< Counter value (the low byte for the link tag).
+        bool full;      //!< Send all 32 bits of the AEAD counter.
+        uint8_t epoch;  //!< m_codecEpoch at assignment; void after SetEncryption() or SetLinkTag().
+    };
+
+    /**
+     * @brief A command waiting in (or dispatched from) the driver's priority queue.
+     */
+    struct QueuedCommand
+    {
+        bool isTx;                  //!< True for @DT data transmission, false for a plain command.
+        MU_Modem_Priority priority; //!< Priority class the command was queued in.
+        MU_Modem_Response expected; //!< Response type reported to the callback (Idle for plain responses).
+        const uint8_t *pMsg;        //!< Payload (data transmission only, not copied). First segment's data for TransmitDataVAsync().
+        const MU_Modem_Segment *pSegments; //!< Segments gathered at dispatch, null for a contiguous payload.
+        uint8_t numSegments;        //!< Number of segments.
+        uint8_t len;                //!< Payload length (data transmission only).
+        bool useRouteRegister;      //!< Append /R (data transmission only).
+        char cmd[16];               //!< Command string including CRLF (plain command only).
+        uint32_t timeoutMs;         //!< Response timeout passed to SerialModemBase.
+        uint32_t enqueuedAt;        //!< millis() when the command was queued.
+        uint32_t dispatchedAt;      //!< millis() when the command was handed to SerialModemBase.
+        uint32_t startedAt;         //!< millis() when SerialModemBase began executing it (head of the pipeline).
+        uint32_t notBefore;         //!< Earliest dispatch time (retry backoff).
+        uint8_t attempts;           //!< Transmission attempts so far (data transmission only).
+        uint8_t wireLen;            //!< Encoded length of the last attempt (data transmission only).
+        TxSeq seq;                  //!< Codec sequence number (data transmission only).
+        uint32_t respUs;            //!< micros() at the '*' of the completing response.
+        bool lbtFailed;             //!< *IR=01 received in place of the *DT response.
+        bool isCarrierSense;        //!< Internal @CS pre-check of the retry scheduler.
+    };
+
+    // Queue slots per class: MU_CMD_QUEUE_DEPTH for producers plus a reserve for requeued retries
+    static constexpr uint8_t MU_QUEUE_CAPACITY = MU_CMD_QUEUE_DEPTH + MU_QUEUE_RETRY_RESERVE;
+
+    // Codec and gather buffers shrink to a placeholder byte when compiled out
+    static constexpr uint8_t MU_WIRE_BUF_LEN = (MU_ENABLE_PAYLOAD_CODEC || MU_ENABLE_TX_GATHER) ? MU_MAX_PAYLOAD_LEN : 1;
+    static constexpr uint8_t MU_GATHER_BUF_LEN = (MU_ENABLE_PAYLOAD_CODEC && MU_ENABLE_TX_GATHER) ? MU_MAX_PAYLOAD_LEN : 1;
+    static constexpr uint8_t MU_DECODE_BUF_LEN = MU_ENABLE_PAYLOAD_CODEC ? MU_MAX_PAYLOAD_LEN : 1;
+
     void m_ResetParser();
+    void m_AssignTxSeq(TxSeq *pSeq);
+    const uint8_t *m_EncodeTxPayload(const uint8_t *pMsg, uint8_t len, const TxSeq &seq, uint8_t *pWire, uint8_t *pWireLen);
+    const uint8_t *m_PrepareTxWire(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                   const TxSeq &seq, uint8_t *pWire, uint8_t *pWireLen);
+    static MU_Modem_Error m_ScanSegments(const MU_Modem_Segment *pSegments, uint8_t numSegments, const uint8_t **ppFirst, uint8_t *pLen);
+    MU_Modem_Error m_TransmitSync(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                  bool useRouteRegister);
+    MU_Modem_Error m_TransmitAsync(const uint8_t *pMsg, const MU_Modem_Segment *pSegments, uint8_t numSegments, uint8_t len,
+                                   bool useRouteRegister, MU_Modem_Priority priority);
+    bool m_DecodeRxPayload(uint8_t *pFrame, uint8_t frameLen, const uint8_t **ppPayload, uint8_t *pLen);
+    MU_Modem_Error m_CheckTxPayload(const uint8_t *pMsg, uint8_t len) const;
+    uint8_t m_MaxWireLen(uint8_t len) const;
+    void m_RefillAirtime();
+    bool m_HasAirtime(uint8_t wireLen);
+    bool m_IsTxGateOpen(uint8_t wireLen);
+    void m_ChargeAirtime(uint8_t wireLen);
+    bool m_AeadCheckSequence(uint8_t sender, const uint8_t *pSeq, bool fullSeq, uint32_t *pSeq32);
+    void m_AeadAcceptSequence(uint8_t sender, uint32_t seq);
+    uint8_t m_FindNeighbor(uint8_t id) const;
+    void m_UpdateNeighbor(uint8_t id, int16_t rssi, bool hasSeq, uint8_t seq);
+    bool m_IsDuplicate();
+    void m_EmitEvent(const MU_Modem_Event &ev) { m_EmitEventFrom(m_pLayers, ev); }
+    void m_EmitEventFrom(MU_Modem_Layer *pLayer, const MU_Modem_Event &ev);
+
+    // Initialization helpers
+    void m_InitDriver(Stream &pUart, MU_Modem_FrequencyModel frequencyModel, MU_Modem_AsyncCallback pCallback);
+    MU_Modem_Error m_InitModem();
+    static uint8_t m_BaudRateCode(uint32_t baudRate);
+    MU_Modem_Error m_ProbeModem();
+    MU_Modem_Error m_ScanBaudRate();
+    MU_Modem_Error m_SwitchHostBaud(uint32_t baudRate);
+    MU_Modem_Error m_VerifyLink();
+    MU_Modem_Error m_TryBaudRate(uint32_t baudRate);
+    void m_UpdateShadow(uint8_t field, uint8_t value);
+    void m_NoteConfigWrite(uint8_t field, bool saveValue);
+    MU_Modem_Error m_VerifyShadow(const MU_Modem_ConfigShadow &expected);
+    MU_Modem_Error m_ApplyShadow(const MU_Modem_ConfigShadow &shadow);
+    MU_Modem_Error m_WriteNvmField(const MU_Modem_NvmConfig &config, uint8_t field, bool saveValue);
+
+    // Command queue helpers
+    MU_Modem_Error m_EnqueueQueued(const QueuedCommand &cmd);
+    MU_Modem_Error m_EnqueueSimpleAsync(const char *cmd, MU_Modem_Priority priority, MU_Modem_Response expected, uint32_t timeoutMs);
+    bool m_IsQueueHeadDue(uint8_t cls, uint32_t now) const;
+    int8_t m_SelectQueueClass() const;
+    void m_DispatchQueued();
+    void m_DropQueueHead(uint8_t cls);
+    bool m_PopInFlight(QueuedCommand *pCmd);
+    void m_ExpireInFlight();
+    bool m_WaitAsyncIdle();
+
+    // Retransmission helpers
+    uint8_t m_InFlightTxCount() const;
+    void m_DispatchCarrierSense();
+    void m_OnCarrierSenseResult(const uint8_t *rxBuf);
+    uint32_t m_RetryBackoffMs(uint8_t attempts) const;
+    void m_OnTxLbtFailure(const QueuedCommand &cmd);
+    void m_FinishTx(const QueuedCommand &cmd, bool delivered);
+    bool m_OnLbtError();
+    void m_ProcessTxVerdicts();
+    void m_AwaitTxVerdict(const QueuedCommand &cmd);
+    bool m_IsModemTxReady();
+    MU_Modem_Error m_WaitModemTxReady(uint32_t timeoutMs);
+    void m_UpdateRxThrottle();
+    void m_NotifyWritable();
 
     // Parser sub-handlers
     ModemParseResult m_HandleReadCmdPrefix(uint8_t c);
@@ -451,9 +1719,28 @@ private:
     ModemParseResult m_HandleRadioDsRssi(uint8_t c);
     ModemParseResult m_HandleRadioDrPayload(uint8_t c);
     ModemParseResult m_HandleReadOptionUntilLF(uint8_t c);
+    void m_FlushRxChunk();
+    void m_DecideRxFrame();
+    bool m_AcceptRxFrame();
+    void m_EndRxStream(MU_Modem_Error err);
 
     MU_Modem_AsyncCallback m_pCallback;
+    MU_Modem_Layer *m_pLayers = nullptr;
     MU_Modem_FrequencyModel m_frequencyModel;
+    MU_Modem_HostBaudCallback m_pSetHostBaud = nullptr;
+    uint32_t m_baudRate = 0;
+
+    // Configuration shadow and init report
+    MU_Modem_ConfigShadow m_shadow;
+    uint32_t m_lastInitTimeMs = 0;
+    bool m_lastInitWarm = false;
+
+    // Staged configuration
+    MU_Modem_NvmConfig m_nvmStaged;
+    MU_Modem_NvmConfig m_nvmSnapshot; // Values NVM holds, as far as known
+    uint8_t m_nvmStagedMask = 0;
+    uint8_t m_nvmSnapshotMask = 0;
+    uint8_t m_nvmVolatileMask = 0; // Fields changed without /W since the last reset: current value may differ from NVM
 
     // Parser State
     MU_Modem_ParserState m_parserState;
@@ -461,22 +1748,143 @@ private:
     // Data Packet Buffer
     // Kept separate from SerialModemBase::_rxBuffer to allow interleaving
     int16_t m_lastRxRSSI;
+    uint32_t m_respStartUs = 0; // micros() at the '*' of the response being parsed
+    uint32_t m_rxStartUs = 0;   // m_respStartUs of the last data frame
+
+    // Streaming receive
+    MU_Modem_RxSink *m_pRxSink = nullptr;
+    bool m_rxStreaming = false; // The payload being parsed goes to m_pRxSink
+    uint8_t m_rxChunkLen = 0;
+    uint8_t m_rxChunk[MU_RX_SINK_CHUNK_LEN];
+
+    // Receive filters
+    MU_Modem_RxFilter m_rxFilters[MU_RX_FILTER_COUNT];
+    uint8_t m_rxFilterCount = 0;
+    uint8_t m_rxFilterPrefixMax = 0; // Longest prefix of the installed filters
+    MU_Modem_RxFilterAction m_rxFilterDefault = MU_Modem_RxFilterAction::Accept;
+    MU_Modem_RxFilterStats m_rxFilterStats;
+    bool m_rxHasRssi = false;        // The frame being parsed came with *DS or *DC
+    bool m_rxUndecided = false;      // Filters and sink still have to see the frame
+    bool m_rxDropping = false;       // The frame being parsed is skipped
+    uint8_t m_rxDecideAt = 0;        // Payload bytes needed for the decision
     uint8_t m_drRouteInfo[MU_MAX_ROUTE_NODES_IN_DR];
     uint8_t m_drNumRouteNodes;
 
     bool m_drMessagePresent = false;
     uint8_t m_drMessageLen = 0;
+    uint8_t m_legacyPacketLen = 0; // Length of the packet held for HasPacket()/GetPacket()
 
     // Pointer to external buffer for legacy polling (GetPacket)
     uint8_t *m_pLegacyBuffer = nullptr;
     uint8_t m_legacyBufferSize = 0;
 
-    // Async Request State
-    MU_Modem_Response m_asyncExpectedResponse;
+    // Priority command queue (ring buffer per class)
+    QueuedCommand m_queue[MU_PRIORITY_CLASS_COUNT][MU_QUEUE_CAPACITY];
+    uint8_t m_queueHead[MU_PRIORITY_CLASS_COUNT];
+    uint8_t m_queueCount[MU_PRIORITY_CLASS_COUNT];
+    uint8_t m_queueSkipCount[MU_PRIORITY_CLASS_COUNT];
+    MU_Modem_QueueStats m_queueStats[MU_PRIORITY_CLASS_COUNT];
+    uint16_t m_queueBytes[MU_PRIORITY_CLASS_COUNT];
+    bool m_writableArmed[MU_PRIORITY_CLASS_COUNT];
+    uint16_t m_writableMinBytes[MU_PRIORITY_CLASS_COUNT];
+
+    // Hardware flow control
+    Stream *m_pUart = nullptr;
+    MU_Modem_FlowControl *m_pFlowControl = nullptr;
+    MU_Modem_PinFlowControl m_pinFlowControl;
+    bool m_rxThrottled = false;
+    uint32_t m_rxThrottleStart = 0;
+    MU_Modem_FlowControlStats m_flowStats = {};
+
+    // Commands handed to SerialModemBase and awaiting completion (FIFO, same order as the base queue)
+    QueuedCommand m_inFlight[MU_TX_PIPELINE_DEPTH];
+    uint8_t m_inFlightHead;
+    uint8_t m_inFlightCount;
+
+    // LBT retransmission
+    MU_Modem_RetryPolicy m_retryPolicy;
+    MU_Modem_RetryStats m_retryStats;
+    QueuedCommand m_txVerdict[MU_TX_VERDICT_DEPTH]; // Accepted frames inside their LBT window (FIFO)
+    uint8_t m_verdictHead;
+    uint8_t m_verdictCount;
+    uint32_t m_csClearAt; // millis() of the last clear @CS result
+
+    // Airtime budget: token bucket counted in microseconds of air time
+    MU_Modem_AirtimePolicy m_airtimePolicy;
+    MU_Modem_AirtimeStats m_airtimeStats;
+    uint32_t m_airtimeTokensUs = 0;
+    uint32_t m_airtimeRemainder = 0; // Refill carry, in units of 1/windowMs us
+    uint32_t m_airtimeRefillAt = 0;
+    uint64_t m_airtimeTotalUs = 0;
+
+    // Payload compression
+    bool m_compressEnabled = false;
+    const uint8_t *m_pCompressDict = nullptr;
+    uint16_t m_compressDictLen = 0;
+    MU_Modem_CompressionStats m_compressStats;
+    uint8_t m_txWire[MU_TX_PIPELINE_DEPTH + 1][MU_WIRE_BUF_LEN]; // Per in-flight slot, last one for TransmitData()
+    uint8_t m_txGather[MU_GATHER_BUF_LEN];                       // Segments awaiting the codec (TransmitDataV with codec on)
+    uint8_t m_rxDecoded[MU_DECODE_BUF_LEN];
+
+    // Authenticated encryption
+    struct AeadPeer
+    {
+        bool valid;
+        uint8_t sender;
+        uint32_t highest;  // Highest authenticated counter
+        uint32_t window;   // Bit n: highest - n was received
+        uint32_t lastRxAt; // millis() of the last frame (LRU eviction)
+    };
+    bool m_aeadEnabled = false;
+    uint8_t m_aeadNodeId = 0;
+    uint8_t m_aeadTagLen = 0;
+    uint8_t m_aeadSyncLeft = 0; // Frames still sent with the full counter after SetEncryption()
+    uint32_t m_aeadTxCounter = 0;
+    MU_AesCcm m_aead;
+    AeadPeer m_aeadPeers[MU_AEAD_MAX_PEERS];
+    MU_Modem_SecurityStats m_securityStats;
+
+    // Link tag and neighbor table
+    struct NeighborState
+    {
+        int16_t rssiQ4;   // EWMA of the RSSI, dBm * 16
+        uint16_t lossQ8;  // EWMA of the loss rate, 256 = 100 %
+        uint8_t lastSeq;
+        bool seqValid;
+    };
+    bool m_linkTagEnabled = false;
+    uint8_t m_linkTagNodeId = 0;
+    uint8_t m_linkTagSeq = 0;
+    uint8_t m_codecEpoch = 0; // Bumped by SetEncryption() and SetLinkTag(): voids the sequence numbers of queued frames
+    bool m_rxHasSender = false; // Set by m_DecodeRxPayload() for the frame being received
+    uint8_t m_rxSender = 0;
+    uint8_t m_rxSeq = 0;
+    MU_Modem_Neighbor m_neighbors[MU_NEIGHBOR_TABLE_SIZE];
+    NeighborState m_neighborState[MU_NEIGHBOR_TABLE_SIZE];
+#if MU_NEIGHBOR_DIRECT_INDEX
+    uint8_t m_neighborIndex[256] = {}; // Sender ID -> entry + 1 (0 = none)
+#endif
+    uint8_t m_neighborCount = 0;
+
+    // Duplicate suppression: open-addressed hash set with linear probing
+    struct DedupEntry
+    {
+        uint32_t key; // 0 = never used
+        uint32_t seenAt;
+    };
+    bool m_dedupEnabled = false;
+    uint32_t m_dedupExpiryMs = 0;
+    DedupEntry m_dedupCache[MU_DEDUP_CACHE_SIZE];
+    MU_Modem_DedupStats m_dedupStats;
 
     // Internal LBT Error Flag (set by parse when *IR=01 is seen)
     volatile bool m_lbtErrorDetected;
 
     // Flag to suppress async callbacks during synchronous operations
     bool m_blockAsyncCallback;
+
+    // Set while a synchronous command waits for the pipeline to drain: nothing new is dispatched
+    bool m_syncDraining = false;
+    // Set while Work() runs, so callbacks issuing synchronous commands do not re-enter it
+    bool m_inWork = false;
 };
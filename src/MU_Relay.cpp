@@ -0,0 +1,356 @@
+//
+// MU_Relay.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Relay.h"
+#include <string.h>
+
+// --- Relay Frame Layout ---
+// [0] MU_PROTO_RELAY
+// [1] Originator node ID
+// [2] Destination node ID (MU_RELAY_BROADCAST = all)
+// [3] Next hop node ID (MU_RELAY_BROADCAST = every node forwards)
+// [4] Previous hop node ID (the transmitter of this copy)
+// [5] Hop count: transmissions including this one
+// [6] Sequence number of the originator
+// [7..] Data
+static constexpr uint8_t RELAY_OFS_ORIGIN = 1;
+static constexpr uint8_t RELAY_OFS_DST = 2;
+static constexpr uint8_t RELAY_OFS_NEXT = 3;
+static constexpr uint8_t RELAY_OFS_PREV = 4;
+static constexpr uint8_t RELAY_OFS_HOPS = 5;
+static constexpr uint8_t RELAY_OFS_SEQ = 6;
+
+MU_Relay::MU_Relay()
+    : m_pModem(nullptr), m_pCallback(nullptr), m_nodeId(0), m_maxHops(MU_RELAY_DEFAULT_MAX_HOPS), m_txSeq(0),
+      m_lastOrigin(0), m_order(0), m_slots(), m_routes(), m_seen(), m_seenNext(0), m_stats()
+{
+}
+
+MU_Modem_Error MU_Relay::begin(MU_Modem &modem, uint8_t nodeId, MU_Relay_Callback pCallback)
+{
+    if (nodeId == MU_RELAY_BROADCAST)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_pCallback = pCallback;
+    m_nodeId = nodeId;
+    m_txSeq = (uint8_t)random(256); // Do not look like a replay of the frames sent before a restart
+    m_lastOrigin = nodeId;
+    m_order = 0;
+    memset(m_slots, 0, sizeof(m_slots));
+    memset(m_routes, 0, sizeof(m_routes));
+    // Seen entries start with the broadcast ID as origin, which no real frame carries
+    for (uint8_t i = 0; i < MU_RELAY_SEEN_CACHE; i++)
+    {
+        m_seen[i].origin = MU_RELAY_BROADCAST;
+        m_seen[i].seq = 0;
+    }
+    m_seenNext = 0;
+    m_stats = MU_Relay_Stats();
+
+    return modem.AttachLayer(this);
+}
+
+MU_Modem_Error MU_Relay::Send(uint8_t dest, const uint8_t *pData, uint8_t len)
+{
+    if (!m_pModem || !pData || len == 0 || len > GetLayerFrameLen(*m_pModem) - MU_RELAY_HEADER_LEN || dest == m_nodeId)
+        return MU_Modem_Error::InvalidArg;
+
+    Slot *pSlot = m_AllocSlot(m_nodeId);
+    if (!pSlot)
+        return MU_Modem_Error::Busy;
+
+    uint8_t seq = m_txSeq++;
+    pSlot->buf[0] = MU_PROTO_RELAY;
+    pSlot->buf[RELAY_OFS_ORIGIN] = m_nodeId;
+    pSlot->buf[RELAY_OFS_DST] = dest;
+    pSlot->buf[RELAY_OFS_HOPS] = 1;
+    pSlot->buf[RELAY_OFS_SEQ] = seq;
+    memcpy(&pSlot->buf[MU_RELAY_HEADER_LEN], pData, len);
+    pSlot->len = MU_RELAY_HEADER_LEN + len;
+    m_CheckSeen(m_nodeId, seq); // Ignore our own frame when a neighbor forwards it back
+    m_stats.originated++;
+
+    m_Dispatch();
+    return MU_Modem_Error::Ok;
+}
+
+uint8_t MU_Relay::GetNextHop(uint8_t dest) const
+{
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MU_RELAY_MAX_ROUTES; i++)
+    {
+        const Route &route = m_routes[i];
+        if (route.used && route.dest == dest && (uint32_t)(now - route.learnedAt) < MU_RELAY_ROUTE_TIMEOUT_MS)
+            return route.nextHop;
+    }
+    return MU_RELAY_BROADCAST;
+}
+
+void MU_Relay::ResetStats()
+{
+    uint8_t depth = m_stats.queueDepth;
+    m_stats = MU_Relay_Stats();
+    m_stats.queueDepth = depth;
+    m_stats.maxQueueDepth = depth;
+}
+
+bool MU_Relay::m_CheckSeen(uint8_t origin, uint8_t seq)
+{
+    for (uint8_t i = 0; i < MU_RELAY_SEEN_CACHE; i++)
+    {
+        if (m_seen[i].origin == origin && m_seen[i].seq == seq)
+            return true;
+    }
+    m_seen[m_seenNext].origin = origin;
+    m_seen[m_seenNext].seq = seq;
+    m_seenNext = (uint8_t)((m_seenNext + 1) % MU_RELAY_SEEN_CACHE);
+    return false;
+}
+
+void MU_Relay::m_Learn(uint8_t dest, uint8_t nextHop, uint8_t hops)
+{
+    if (dest == m_nodeId || dest == MU_RELAY_BROADCAST)
+        return;
+
+    uint32_t now = millis();
+    Route *pRoute = nullptr;
+    Route *pOldest = &m_routes[0];
+    for (uint8_t i = 0; i < MU_RELAY_MAX_ROUTES; i++)
+    {
+        Route &route = m_routes[i];
+        if (route.used && route.dest == dest)
+        {
+            pRoute = &route;
+            break;
+        }
+        // Replacement candidate: a free entry, else the least recently learned route
+        if (pOldest->used && (!route.used || (int32_t)(route.learnedAt - pOldest->learnedAt) < 0))
+            pOldest = &route;
+    }
+
+    if (pRoute)
+    {
+        // Keep a shorter path while it is fresh; the same neighbor just refreshes it
+        bool expired = (uint32_t)(now - pRoute->learnedAt) >= MU_RELAY_ROUTE_TIMEOUT_MS;
+        if (pRoute->nextHop != nextHop && hops > pRoute->hops && !expired)
+            return;
+    }
+    else
+    {
+        pRoute = pOldest;
+        pRoute->used = true;
+        pRoute->dest = dest;
+    }
+    pRoute->nextHop = nextHop;
+    pRoute->hops = hops;
+    pRoute->learnedAt = now;
+}
+
+MU_Relay::Slot *MU_Relay::m_AllocSlot(uint8_t origin)
+{
+    for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+    {
+        if (m_slots[i].state == SlotState::Free)
+        {
+            m_slots[i].state = SlotState::Waiting;
+            m_slots[i].order = m_order++;
+            m_UpdateDepth();
+            return &m_slots[i];
+        }
+    }
+
+    // Full: the flow with the most waiting frames gives up its newest one, unless that is the requester itself
+    uint8_t counts[MU_RELAY_QUEUE_SIZE] = {};
+    uint8_t own = 0;
+    for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+    {
+        if (m_slots[i].state != SlotState::Waiting)
+            continue;
+        uint8_t flow = m_slots[i].buf[RELAY_OFS_ORIGIN];
+        if (flow == origin)
+            own++;
+        for (uint8_t j = 0; j < MU_RELAY_QUEUE_SIZE; j++)
+        {
+            if (m_slots[j].state == SlotState::Waiting && m_slots[j].buf[RELAY_OFS_ORIGIN] == flow)
+                counts[i]++;
+        }
+    }
+
+    Slot *pVictim = nullptr;
+    uint8_t victimCount = own + 1;
+    for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+    {
+        if (m_slots[i].state != SlotState::Waiting || counts[i] < victimCount)
+            continue;
+        if (counts[i] > victimCount || !pVictim || m_slots[i].order > pVictim->order)
+        {
+            pVictim = &m_slots[i];
+            victimCount = counts[i];
+        }
+    }
+
+    if (!pVictim)
+        return nullptr; // The caller decides whether the new frame is lost
+
+    m_stats.queueDrops++;
+    pVictim->order = m_order++;
+    return pVictim;
+}
+
+void MU_Relay::m_Dispatch()
+{
+    uint8_t inModem = 0;
+    for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+    {
+        if (m_slots[i].state == SlotState::Queued)
+            inModem++;
+    }
+
+    while (inModem < MU_TX_PIPELINE_DEPTH)
+    {
+        // Round-robin over flows: the next originator after the one served last, oldest frame first
+        Slot *pNext = nullptr;
+        uint8_t bestDistance = 0;
+        for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+        {
+            Slot &slot = m_slots[i];
+            if (slot.state != SlotState::Waiting)
+                continue;
+            uint8_t distance = (uint8_t)(slot.buf[RELAY_OFS_ORIGIN] - m_lastOrigin - 1);
+            if (!pNext || distance < bestDistance || (distance == bestDistance && slot.order < pNext->order))
+            {
+                pNext = &slot;
+                bestDistance = distance;
+            }
+        }
+        if (!pNext)
+            return;
+
+        uint8_t dest = pNext->buf[RELAY_OFS_DST];
+        uint8_t nextHop = (dest == MU_RELAY_BROADCAST) ? MU_RELAY_BROADCAST : GetNextHop(dest);
+        pNext->buf[RELAY_OFS_NEXT] = nextHop;
+        pNext->buf[RELAY_OFS_PREV] = m_nodeId;
+
+        if (m_pModem->TransmitDataAsync(pNext->buf, pNext->len) != MU_Modem_Error::Ok)
+            return; // Work() retries
+
+        pNext->state = SlotState::Queued;
+        m_lastOrigin = pNext->buf[RELAY_OFS_ORIGIN];
+        inModem++;
+        if (m_lastOrigin != m_nodeId)
+            m_stats.forwarded++;
+        if (nextHop == MU_RELAY_BROADCAST && dest != MU_RELAY_BROADCAST)
+            m_stats.flooded++;
+    }
+}
+
+void MU_Relay::m_UpdateDepth()
+{
+    uint8_t depth = 0;
+    for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+    {
+        if (m_slots[i].state != SlotState::Free)
+            depth++;
+    }
+    m_stats.queueDepth = depth;
+    if (depth > m_stats.maxQueueDepth)
+        m_stats.maxQueueDepth = depth;
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Relay::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    (void)modem;
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        for (uint8_t i = 0; i < MU_RELAY_QUEUE_SIZE; i++)
+        {
+            Slot &slot = m_slots[i];
+            if (slot.state != SlotState::Queued || event.pPayload != slot.buf)
+                continue;
+
+            slot.state = SlotState::Free;
+            if (event.type == MU_Modem_Response::TxFailed)
+                m_stats.txFailed++;
+            m_UpdateDepth();
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived || event.payloadLen < MU_RELAY_HEADER_LEN ||
+        event.pPayload[0] != MU_PROTO_RELAY)
+        return false;
+
+    const uint8_t *pFrame = event.pPayload;
+    uint8_t origin = pFrame[RELAY_OFS_ORIGIN];
+    uint8_t dest = pFrame[RELAY_OFS_DST];
+    uint8_t prevHop = pFrame[RELAY_OFS_PREV];
+    uint8_t hops = pFrame[RELAY_OFS_HOPS];
+
+    // Reverse path: the transmitter is a neighbor and leads back to the originator
+    m_Learn(prevHop, prevHop, 1);
+    m_Learn(origin, prevHop, hops);
+
+    if (origin == m_nodeId || m_CheckSeen(origin, pFrame[RELAY_OFS_SEQ]))
+    {
+        m_stats.duplicates++;
+        return true;
+    }
+
+    if (dest == m_nodeId || dest == MU_RELAY_BROADCAST)
+    {
+        m_stats.delivered++;
+        if (m_pCallback)
+        {
+            MU_Relay_Event ev;
+            ev.origin = origin;
+            ev.hops = hops;
+            ev.rssi = (int16_t)event.value;
+            ev.pData = pFrame + MU_RELAY_HEADER_LEN;
+            ev.len = (uint8_t)(event.payloadLen - MU_RELAY_HEADER_LEN);
+            m_pCallback(ev);
+        }
+        if (dest == m_nodeId)
+            return true;
+    }
+
+    uint8_t nextHop = pFrame[RELAY_OFS_NEXT];
+    if (nextHop != m_nodeId && nextHop != MU_RELAY_BROADCAST)
+        return true; // Another node's job
+
+    if (hops >= m_maxHops)
+    {
+        m_stats.hopLimit++;
+        return true;
+    }
+
+    Slot *pSlot = m_AllocSlot(origin);
+    if (!pSlot)
+    {
+        m_stats.queueDrops++;
+        return true;
+    }
+
+    memcpy(pSlot->buf, pFrame, event.payloadLen);
+    pSlot->buf[RELAY_OFS_HOPS] = (uint8_t)(hops + 1);
+    pSlot->len = (uint8_t)event.payloadLen;
+    m_Dispatch();
+    return true;
+}
+
+void MU_Relay::OnModemWork(MU_Modem &modem)
+{
+    (void)modem;
+    if (m_pModem)
+        m_Dispatch();
+}
@@ -0,0 +1,194 @@
+/**
+ * @file MU_Relay.h
+ * @brief Store-and-forward multi-hop relaying on top of MU_Modem.
+ *
+ * The modem's route register relays through at most 10 fixed hops that the
+ * source must know in advance. This layer forwards frames hop by hop instead:
+ * every node learns the reverse path to each originator it hears from, queues
+ * frames to forward in a bounded buffer served round-robin per flow, and
+ * retransmits them towards the next hop with TransmitDataAsync(). Destinations
+ * without a known route are reached by a controlled flood.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Frames the forwarding queue holds (locally originated frames included).
+ */
+#ifndef MU_RELAY_QUEUE_SIZE
+#define MU_RELAY_QUEUE_SIZE 4
+#endif
+
+/**
+ * @brief Destinations in the route table.
+ */
+#ifndef MU_RELAY_MAX_ROUTES
+#define MU_RELAY_MAX_ROUTES 16
+#endif
+
+/**
+ * @brief Recently seen (originator, sequence) pairs remembered to stop flooded copies.
+ */
+#ifndef MU_RELAY_SEEN_CACHE
+#define MU_RELAY_SEEN_CACHE 16
+#endif
+
+static constexpr uint8_t MU_RELAY_HEADER_LEN = 7;                                          //!< Relay header bytes per frame
+static constexpr uint8_t MU_RELAY_MAX_DATA_LEN = MU_LAYER_PAYLOAD_LEN - MU_RELAY_HEADER_LEN; //!< Max user bytes per frame
+static constexpr uint8_t MU_RELAY_BROADCAST = 0xFF;                                        //!< All nodes; also "next hop unknown"
+static constexpr uint8_t MU_RELAY_DEFAULT_MAX_HOPS = 16;                                   //!< Hop limit of a frame
+static constexpr uint32_t MU_RELAY_ROUTE_TIMEOUT_MS = 120000;                              //!< Learned routes expire after this
+
+/**
+ * @struct MU_Relay_Event
+ * @brief A frame delivered to this node.
+ */
+struct MU_Relay_Event
+{
+    uint8_t origin;       //!< Node ID of the originator.
+    uint8_t hops;         //!< Number of transmissions the frame took.
+    int16_t rssi;         //!< RSSI of the last hop [dBm].
+    const uint8_t *pData; //!< Data. Only valid during the callback.
+    uint8_t len;          //!< Length of pData.
+};
+
+/**
+ * @typedef MU_Relay_Callback
+ * @brief Callback function type for frames delivered by MU_Relay.
+ */
+typedef void (*MU_Relay_Callback)(const MU_Relay_Event &event);
+
+/**
+ * @struct MU_Relay_Stats
+ * @brief Counters of the relay.
+ */
+struct MU_Relay_Stats
+{
+    uint32_t originated;  //!< Frames accepted by Send().
+    uint32_t delivered;   //!< Frames delivered to this node.
+    uint32_t forwarded;   //!< Frames of other nodes handed to the modem.
+    uint32_t flooded;     //!< Frames sent without a known next hop.
+    uint32_t duplicates;  //!< Copies of already seen frames ignored.
+    uint32_t hopLimit;    //!< Frames not forwarded because they reached the hop limit.
+    uint32_t queueDrops;  //!< Frames discarded because the queue was full (fairness included; a Busy Send() is not counted).
+    uint32_t txFailed;    //!< Frames reported as TxFailed by the modem.
+    uint8_t queueDepth;   //!< Frames currently queued or in the modem.
+    uint8_t maxQueueDepth; //!< Highest queueDepth since the last reset.
+};
+
+/**
+ * @class MU_Relay
+ * @brief Store-and-forward relay layer for MU_Modem.
+ *
+ * Nodes are identified by one-byte IDs chosen by the application and carried in the
+ * relay header, so all nodes must hear each other's frames (same group, broadcast
+ * destination). Routes are learned from the previous hop of every received frame.
+ * When the forwarding queue is full, the flow (originator) holding the most entries
+ * gives one up, so a chatty node cannot starve the others.
+ */
+class MU_Relay : public MU_Modem_Layer
+{
+public:
+    MU_Relay();
+
+    /**
+     * @brief Initializes the relay and attaches it to the driver.
+     * @param modem The driver to transmit through.
+     * @param nodeId Own node ID (0x00-0xFE).
+     * @param pCallback Callback for frames addressed to this node (or broadcast).
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if nodeId is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t nodeId, MU_Relay_Callback pCallback);
+
+    /**
+     * @brief Queues data for multi-hop delivery. The data is copied.
+     * @param dest Node ID of the destination, or MU_RELAY_BROADCAST for every node.
+     * @param pData Data to send.
+     * @param len Length of the data (1 to MU_RELAY_MAX_DATA_LEN, less the driver's framing overhead
+     * when encryption or the link tag is enabled).
+     * @return MU_Modem_Error::Ok if accepted, MU_Modem_Error::Busy if the queue is full,
+     * MU_Modem_Error::InvalidArg for bad arguments.
+     */
+    MU_Modem_Error Send(uint8_t dest, const uint8_t *pData, uint8_t len);
+
+    /**
+     * @brief Sets the hop limit of frames originated here and forwarded by this node.
+     * @param maxHops Maximum number of transmissions of a frame (1 = no relaying).
+     */
+    void SetMaxHops(uint8_t maxHops) { m_maxHops = maxHops ? maxHops : 1; }
+
+    /**
+     * @brief Returns the next hop towards a destination.
+     * @param dest Node ID of the destination.
+     * @return Node ID of the next hop, or MU_RELAY_BROADCAST if no route is known.
+     */
+    uint8_t GetNextHop(uint8_t dest) const;
+
+    /**
+     * @brief Returns the relay counters.
+     */
+    const MU_Relay_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the relay counters (queueDepth is kept).
+     */
+    void ResetStats();
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    enum class SlotState : uint8_t
+    {
+        Free,
+        Waiting, // In the forwarding queue
+        Queued   // Handed to the modem, waiting for TxComplete/TxFailed
+    };
+
+    struct Slot
+    {
+        SlotState state;
+        uint8_t len;
+        uint32_t order; // Arrival order, FIFO within a flow
+        uint8_t buf[MU_MAX_PAYLOAD_LEN];
+    };
+
+    struct Route
+    {
+        bool used;
+        uint8_t dest;
+        uint8_t nextHop;
+        uint8_t hops;
+        uint32_t learnedAt;
+    };
+
+    struct Seen
+    {
+        uint8_t origin;
+        uint8_t seq;
+    };
+
+    bool m_CheckSeen(uint8_t origin, uint8_t seq);
+    void m_Learn(uint8_t dest, uint8_t nextHop, uint8_t hops);
+    Slot *m_AllocSlot(uint8_t origin);
+    void m_Dispatch();
+    void m_UpdateDepth();
+
+    MU_Modem *m_pModem;
+    MU_Relay_Callback m_pCallback;
+    uint8_t m_nodeId;
+    uint8_t m_maxHops;
+    uint8_t m_txSeq;
+    uint8_t m_lastOrigin; // Flow served last (round-robin)
+    uint32_t m_order;
+    Slot m_slots[MU_RELAY_QUEUE_SIZE];
+    Route m_routes[MU_RELAY_MAX_ROUTES];
+    Seen m_seen[MU_RELAY_SEEN_CACHE];
+    uint8_t m_seenNext;
+    MU_Relay_Stats m_stats;
+};
@@ -0,0 +1,569 @@
+//
+// MU_ReliableLink.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_ReliableLink.h"
+#include <string.h>
+
+// --- Link Frame Layout ---
+// [0] MU_PROTO_RELIABLE
+// [1] Flags
+// [2] Source node ID
+// [3] Destination node ID
+// [4] Session tag of the sender's sequence space
+// [5] Sequence number (DATA only)
+// [6] Cumulative ACK: next sequence number expected from the destination
+// [7] Selective ACK bitmap: bit i = (ACK + 1 + i) has been received
+static constexpr uint8_t RL_OFS_FLAGS = 1;
+static constexpr uint8_t RL_OFS_SRC = 2;
+static constexpr uint8_t RL_OFS_DST = 3;
+static constexpr uint8_t RL_OFS_SESSION = 4;
+static constexpr uint8_t RL_OFS_SEQ = 5;
+static constexpr uint8_t RL_OFS_ACK = 6;
+static constexpr uint8_t RL_OFS_SACK = 7;
+
+static constexpr uint8_t RL_FLAG_DATA = 0x01;
+static constexpr uint8_t RL_FLAG_ACK = 0x02;
+static constexpr uint8_t RL_FLAG_RESYNC = 0x04; // Session tag changed after a failed frame; receive state kept
+
+static constexpr uint8_t RL_SACK_BITS = 8;
+
+MU_ReliableLink::MU_ReliableLink()
+    : m_pModem(nullptr), m_pCallback(nullptr), m_nodeId(0), m_maxRetries(MU_RL_DEFAULT_MAX_RETRIES),
+      m_peers(), m_tx(), m_rx(), m_ackBuf(), m_ackQueued(false), m_txOrder(0), m_stats()
+{
+}
+
+MU_Modem_Error MU_ReliableLink::begin(MU_Modem &modem, uint8_t nodeId, MU_ReliableLink_Callback pCallback)
+{
+    if (nodeId == MU_RL_BROADCAST_NODE)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_pCallback = pCallback;
+    m_nodeId = nodeId;
+    memset(m_peers, 0, sizeof(m_peers));
+    memset(m_tx, 0, sizeof(m_tx));
+    memset(m_rx, 0, sizeof(m_rx));
+    m_ackQueued = false;
+    m_txOrder = 0;
+    m_stats = MU_ReliableLink_Stats();
+
+    return modem.AttachLayer(this);
+}
+
+// --- Sending ---
+
+MU_Modem_Error MU_ReliableLink::Send(uint8_t peer, const uint8_t *pData, uint8_t len)
+{
+    if (!m_pModem || !pData || len == 0 || len > GetLayerFrameLen(*m_pModem) - MU_RL_HEADER_LEN || peer == MU_RL_BROADCAST_NODE)
+        return MU_Modem_Error::InvalidArg;
+
+    int8_t slotIndex = -1;
+    for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+    {
+        if (!m_tx[i].used)
+        {
+            slotIndex = i;
+            break;
+        }
+    }
+    if (slotIndex < 0)
+        return MU_Modem_Error::Busy;
+
+    int8_t peerIndex = m_GetPeer(peer);
+    if (peerIndex < 0)
+        return MU_Modem_Error::Busy;
+
+    Peer &p = m_peers[peerIndex];
+    TxSlot &slot = m_tx[slotIndex];
+    slot.used = true;
+    slot.queued = false;
+    slot.sent = false;
+    slot.acked = false;
+    slot.sacked = false;
+    slot.retransmitted = false;
+    slot.peerIndex = peerIndex;
+    slot.retries = 0;
+    slot.len = MU_RL_HEADER_LEN + len;
+    slot.order = m_txOrder++;
+    slot.rto = p.rto;
+    slot.buf[RL_OFS_SEQ] = p.txNextSeq++;
+    memcpy(&slot.buf[MU_RL_HEADER_LEN], pData, len);
+    p.lastActive = millis();
+
+    // If the modem queue is full the frame stays pending and Work() retries it
+    m_Transmit(slot);
+    return MU_Modem_Error::Ok;
+}
+
+uint8_t MU_ReliableLink::GetFreeSlots() const
+{
+    uint8_t free = 0;
+    for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+    {
+        if (!m_tx[i].used)
+            free++;
+    }
+    return free;
+}
+
+uint32_t MU_ReliableLink::GetRto(uint8_t peer) const
+{
+    int8_t peerIndex = m_FindPeer(peer);
+    return (peerIndex < 0) ? MU_RL_INITIAL_RTO_MS : m_peers[peerIndex].rto;
+}
+
+void MU_ReliableLink::m_FillHeader(uint8_t *pFrame, uint8_t flags, uint8_t peerIndex)
+{
+    Peer &p = m_peers[peerIndex];
+
+    uint8_t sack = 0;
+    for (uint8_t i = 0; i < MU_RL_RX_REORDER; i++)
+    {
+        if (m_rx[i].used && m_rx[i].peerIndex == peerIndex)
+        {
+            uint8_t bit = (uint8_t)(m_rx[i].seq - p.rxNextSeq - 1);
+            if (bit < RL_SACK_BITS)
+                sack |= (uint8_t)(1 << bit);
+        }
+    }
+
+    pFrame[0] = MU_PROTO_RELIABLE;
+    pFrame[RL_OFS_FLAGS] = flags | RL_FLAG_ACK | (p.txResync ? RL_FLAG_RESYNC : 0);
+    pFrame[RL_OFS_SRC] = m_nodeId;
+    pFrame[RL_OFS_DST] = p.node;
+    pFrame[RL_OFS_SESSION] = p.txSession;
+    pFrame[RL_OFS_ACK] = p.rxNextSeq;
+    pFrame[RL_OFS_SACK] = sack;
+
+    // Every frame carries the acknowledgement, so a pending bare ACK is no longer needed
+    p.ackPending = false;
+}
+
+void MU_ReliableLink::m_Transmit(TxSlot &slot)
+{
+    // Refresh the piggybacked ACK right before handing the frame to the modem
+    bool ackPending = m_peers[slot.peerIndex].ackPending;
+    m_FillHeader(slot.buf, RL_FLAG_DATA, slot.peerIndex);
+
+    if (m_pModem->TransmitDataAsync(slot.buf, slot.len) == MU_Modem_Error::Ok)
+    {
+        slot.queued = true;
+        m_stats.framesSent++;
+    }
+    else
+    {
+        // Not accepted; the ACK still has to go out
+        m_peers[slot.peerIndex].ackPending = ackPending;
+    }
+}
+
+void MU_ReliableLink::m_SendAck(uint8_t peerIndex)
+{
+    if (m_ackQueued)
+        return; // One bare ACK at a time; the next Work() picks up the rest
+
+    m_FillHeader(m_ackBuf, 0, peerIndex);
+    m_ackBuf[RL_OFS_SEQ] = 0;
+
+    // ACKs bypass bulk data so the sender's RTT samples stay accurate
+    if (m_pModem->TransmitDataAsync(m_ackBuf, MU_RL_HEADER_LEN, false, MU_Modem_Priority::UrgentTx) == MU_Modem_Error::Ok)
+    {
+        m_ackQueued = true;
+        m_stats.acksSent++;
+    }
+    else
+    {
+        m_peers[peerIndex].ackPending = true;
+    }
+}
+
+// --- Peer Table ---
+
+int8_t MU_ReliableLink::m_FindPeer(uint8_t node) const
+{
+    for (uint8_t i = 0; i < MU_RL_MAX_PEERS; i++)
+    {
+        if (m_peers[i].used && m_peers[i].node == node)
+            return i;
+    }
+    return -1;
+}
+
+int8_t MU_ReliableLink::m_GetPeer(uint8_t node)
+{
+    int8_t peerIndex = m_FindPeer(node);
+    if (peerIndex >= 0)
+        return peerIndex;
+
+    // Take a free entry, or evict the least recently active peer without buffered frames
+    uint32_t now = millis();
+    uint32_t oldestAge = 0;
+    for (uint8_t i = 0; i < MU_RL_MAX_PEERS; i++)
+    {
+        if (!m_peers[i].used)
+        {
+            peerIndex = i;
+            break;
+        }
+
+        bool busy = m_peers[i].ackPending;
+        for (uint8_t j = 0; j < MU_RL_TX_WINDOW && !busy; j++)
+            busy = m_tx[j].used && m_tx[j].peerIndex == i;
+        for (uint8_t j = 0; j < MU_RL_RX_REORDER && !busy; j++)
+            busy = m_rx[j].used && m_rx[j].peerIndex == i;
+        if (busy)
+            continue;
+
+        uint32_t age = now - m_peers[i].lastActive;
+        if (peerIndex < 0 || age > oldestAge)
+        {
+            peerIndex = i;
+            oldestAge = age;
+        }
+    }
+    if (peerIndex < 0)
+        return -1;
+
+    Peer &p = m_peers[peerIndex];
+    memset(&p, 0, sizeof(p));
+    p.used = true;
+    p.node = node;
+    // A fresh tag tells the peer to restart its receive state for us
+    p.txSession = (uint8_t)random(1, 256);
+    p.rto = MU_RL_INITIAL_RTO_MS;
+    p.lastActive = now;
+    return peerIndex;
+}
+
+void MU_ReliableLink::m_RestartSession(uint8_t peerIndex, bool resync)
+{
+    // The peer lost its state for us, or a frame was given up and left a gap it would wait on forever:
+    // restart our sequence space at 0 and renumber the unacknowledged frames in their original order.
+    Peer &p = m_peers[peerIndex];
+    p.txResync = resync;
+    uint8_t oldSession = p.txSession;
+    do
+    {
+        p.txSession = (uint8_t)random(1, 256);
+    } while (p.txSession == oldSession);
+
+    uint8_t seq = 0;
+    uint32_t lastOrder = 0;
+    bool first = true;
+    for (;;)
+    {
+        TxSlot *pNext = nullptr;
+        for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+        {
+            TxSlot &slot = m_tx[i];
+            if (!slot.used || slot.acked || slot.peerIndex != peerIndex)
+                continue;
+            if (!first && (int32_t)(slot.order - lastOrder) <= 0)
+                continue;
+            if (!pNext || (int32_t)(slot.order - pNext->order) < 0)
+                pNext = &slot;
+        }
+        if (!pNext)
+            break;
+
+        pNext->buf[RL_OFS_SEQ] = seq++;
+        pNext->retransmitted = true; // Karn: no RTT sample across the restart
+        pNext->sacked = false;       // The peer drops its reorder buffer for the old session
+        if (!pNext->queued)
+            pNext->sent = false; // Resend with the new numbering on the next Work()
+        lastOrder = pNext->order;
+        first = false;
+    }
+    p.txNextSeq = seq;
+}
+
+// --- Receiving ---
+
+void MU_ReliableLink::m_OnAck(uint8_t peerIndex, uint8_t ack, uint8_t sack)
+{
+    Peer &p = m_peers[peerIndex];
+
+    // An ACK beyond anything we could have outstanding is stale
+    if ((uint8_t)(p.txNextSeq - ack) > MU_RL_TX_WINDOW)
+        return;
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+    {
+        TxSlot &slot = m_tx[i];
+        if (!slot.used || slot.acked || slot.peerIndex != peerIndex)
+            continue;
+
+        uint8_t seq = slot.buf[RL_OFS_SEQ];
+        uint8_t dist = (uint8_t)(seq - ack);
+        bool cumulative = dist >= 0x80;
+        bool selective = dist >= 1 && dist <= RL_SACK_BITS && (sack & (1 << (dist - 1)));
+        if (!cumulative && !selective)
+            continue;
+
+        if (slot.sent && !slot.retransmitted && !slot.sacked)
+            m_UpdateRto(p, now - slot.sentAt);
+
+        if (!cumulative)
+        {
+            // Buffered by the peer but not delivered yet: stop retransmitting, keep the frame until
+            // the gap before it is filled (or given up, which resends it in a new session)
+            slot.sacked = true;
+            continue;
+        }
+
+        m_stats.framesAcked++;
+        if (slot.queued)
+            slot.acked = true; // Buffer still referenced by the modem queue
+        else
+            slot.used = false;
+        m_Notify(MU_ReliableLink_EventType::Acked, p.node, seq, nullptr, 0);
+    }
+}
+
+void MU_ReliableLink::m_OnData(uint8_t peerIndex, uint8_t seq, const uint8_t *pData, uint8_t len)
+{
+    Peer &p = m_peers[peerIndex];
+
+    // Acknowledge everything, duplicates included, so a lost ACK is repaired
+    if (!p.ackPending)
+    {
+        p.ackPending = true;
+        p.ackDueAt = millis() + MU_RL_ACK_DELAY_MS;
+    }
+
+    uint8_t dist = (uint8_t)(seq - p.rxNextSeq);
+    if (dist >= 0x80)
+    {
+        m_stats.duplicates++;
+        return;
+    }
+
+    if (dist > 0)
+    {
+        // Out of order: buffer it if it fits in the SACK range
+        if (dist > RL_SACK_BITS)
+            return;
+        int8_t freeIndex = -1;
+        for (uint8_t i = 0; i < MU_RL_RX_REORDER; i++)
+        {
+            if (m_rx[i].used && m_rx[i].peerIndex == peerIndex && m_rx[i].seq == seq)
+            {
+                m_stats.duplicates++;
+                return;
+            }
+            if (!m_rx[i].used && freeIndex < 0)
+                freeIndex = i;
+        }
+        if (freeIndex < 0)
+            return; // No room; the sender retransmits after its timeout
+
+        RxSlot &slot = m_rx[freeIndex];
+        slot.used = true;
+        slot.peerIndex = peerIndex;
+        slot.seq = seq;
+        slot.len = len;
+        memcpy(slot.buf, pData, len);
+        return;
+    }
+
+    // In order: deliver straight from the receive buffer, then drain the reorder buffer
+    p.rxNextSeq++;
+    m_Notify(MU_ReliableLink_EventType::Delivered, p.node, seq, pData, len);
+
+    bool found = true;
+    while (found)
+    {
+        found = false;
+        for (uint8_t i = 0; i < MU_RL_RX_REORDER; i++)
+        {
+            RxSlot &slot = m_rx[i];
+            if (slot.used && slot.peerIndex == peerIndex && slot.seq == p.rxNextSeq)
+            {
+                p.rxNextSeq++;
+                m_Notify(MU_ReliableLink_EventType::Delivered, p.node, slot.seq, slot.buf, slot.len);
+                slot.used = false;
+                found = true;
+                break;
+            }
+        }
+    }
+}
+
+void MU_ReliableLink::m_UpdateRto(Peer &peer, uint32_t rttMs)
+{
+    // Jacobson/Karels: SRTT += (R - SRTT) / 8, RTTVAR += (|R - SRTT| - RTTVAR) / 4
+    if (peer.srtt == 0)
+    {
+        peer.srtt = (rttMs > 0) ? rttMs : 1;
+        peer.rttvar = rttMs / 2;
+    }
+    else
+    {
+        uint32_t delta = (rttMs > peer.srtt) ? (rttMs - peer.srtt) : (peer.srtt - rttMs);
+        peer.rttvar = (3 * peer.rttvar + delta) / 4;
+        peer.srtt = (7 * peer.srtt + rttMs) / 8;
+        if (peer.srtt == 0)
+            peer.srtt = 1;
+    }
+
+    uint32_t rto = peer.srtt + 4 * peer.rttvar;
+    if (rto < MU_RL_MIN_RTO_MS)
+        rto = MU_RL_MIN_RTO_MS;
+    if (rto > MU_RL_MAX_RTO_MS)
+        rto = MU_RL_MAX_RTO_MS;
+    peer.rto = rto;
+    m_stats.srttMs = peer.srtt;
+}
+
+void MU_ReliableLink::m_Notify(MU_ReliableLink_EventType type, uint8_t peer, uint8_t seq, const uint8_t *pData, uint8_t len)
+{
+    if (!m_pCallback)
+        return;
+    MU_ReliableLink_Event ev;
+    ev.type = type;
+    ev.peer = peer;
+    ev.seq = seq;
+    ev.pData = pData;
+    ev.len = len;
+    m_pCallback(ev);
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_ReliableLink::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    (void)modem;
+
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        if (event.pPayload == nullptr)
+            return false;
+        if (event.pPayload == m_ackBuf)
+        {
+            m_ackQueued = false;
+            return true;
+        }
+        for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+        {
+            TxSlot &slot = m_tx[i];
+            if (!slot.used || !slot.queued || event.pPayload != slot.buf)
+                continue;
+
+            slot.queued = false;
+            if (slot.acked)
+            {
+                slot.used = false;
+                return true;
+            }
+            // The timer starts when the frame is on air; a failed attempt is retried on timeout
+            slot.sent = true;
+            slot.sentAt = millis();
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived || event.payloadLen < MU_RL_HEADER_LEN ||
+        event.pPayload[0] != MU_PROTO_RELIABLE)
+        return false;
+
+    // Link frame from here on: never passed to the application
+    const uint8_t *pFrame = event.pPayload;
+    if (!m_pModem || pFrame[RL_OFS_DST] != m_nodeId || pFrame[RL_OFS_SESSION] == 0)
+        return true;
+
+    int8_t peerIndex = m_GetPeer(pFrame[RL_OFS_SRC]);
+    if (peerIndex < 0)
+        return true;
+
+    Peer &p = m_peers[peerIndex];
+    p.lastActive = millis();
+
+    uint8_t session = pFrame[RL_OFS_SESSION];
+    bool restarted = false;
+    if (session != p.rxSession)
+    {
+        if (session == p.rxPrevSession)
+            return true; // Late frame from before the peer restarted
+
+        if (p.rxSession != 0 && !(pFrame[RL_OFS_FLAGS] & RL_FLAG_RESYNC))
+        {
+            // A new tag means the peer lost its state: ACKs in this frame refer to our old numbering
+            m_RestartSession(peerIndex, false);
+            restarted = true;
+        }
+        p.rxPrevSession = p.rxSession;
+        p.rxSession = session;
+        p.rxNextSeq = 0;
+        for (uint8_t i = 0; i < MU_RL_RX_REORDER; i++)
+        {
+            if (m_rx[i].used && m_rx[i].peerIndex == peerIndex)
+                m_rx[i].used = false;
+        }
+    }
+
+    uint8_t flags = pFrame[RL_OFS_FLAGS];
+    if ((flags & RL_FLAG_ACK) && !restarted)
+        m_OnAck(peerIndex, pFrame[RL_OFS_ACK], pFrame[RL_OFS_SACK]);
+
+    if (flags & RL_FLAG_DATA)
+        m_OnData(peerIndex, pFrame[RL_OFS_SEQ], pFrame + MU_RL_HEADER_LEN, event.payloadLen - MU_RL_HEADER_LEN);
+
+    return true;
+}
+
+void MU_ReliableLink::OnModemWork(MU_Modem &modem)
+{
+    (void)modem;
+    if (!m_pModem)
+        return;
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < MU_RL_TX_WINDOW; i++)
+    {
+        TxSlot &slot = m_tx[i];
+        if (!slot.used || slot.queued || slot.acked || slot.sacked)
+            continue;
+
+        if (slot.sent)
+        {
+            if ((uint32_t)(now - slot.sentAt) < slot.rto)
+                continue;
+
+            if (slot.retries >= m_maxRetries)
+            {
+                // The peer delivers in order only and would stall at this gap: start a new session
+                // so it resets its receive state, without renumbering its own frames
+                slot.used = false;
+                m_stats.framesFailed++;
+                m_Notify(MU_ReliableLink_EventType::Failed, m_peers[slot.peerIndex].node, slot.buf[RL_OFS_SEQ], nullptr, 0);
+                m_RestartSession(slot.peerIndex, true);
+                continue;
+            }
+
+            // Exponential backoff of the timer; Karn's rule keeps the sample out of the estimate
+            slot.retries++;
+            slot.retransmitted = true;
+            slot.rto = (slot.rto * 2 > MU_RL_MAX_RTO_MS) ? MU_RL_MAX_RTO_MS : slot.rto * 2;
+            slot.sent = false;
+            m_stats.retransmissions++;
+        }
+        m_Transmit(slot);
+    }
+
+    for (uint8_t i = 0; i < MU_RL_MAX_PEERS; i++)
+    {
+        Peer &p = m_peers[i];
+        if (p.used && p.ackPending && (int32_t)(now - p.ackDueAt) >= 0)
+            m_SendAck(i);
+    }
+}
@@ -0,0 +1,228 @@
+/**
+ * @file MU_ReliableLink.h
+ * @brief Optional reliable, in-order transport on top of MU_Modem.
+ *
+ * Adds per-peer sequence numbers, selective acknowledgements piggybacked on
+ * reverse traffic, a sliding window and adaptive retransmission timeouts to
+ * the fire-and-forget @DT frames of the MU modem.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+/**
+ * @brief Number of unacknowledged frames the link may have outstanding (shared by all peers).
+ * Each slot holds a copy of one frame. Must be at least MU_TX_PIPELINE_DEPTH to keep the modem busy.
+ */
+#ifndef MU_RL_TX_WINDOW
+#define MU_RL_TX_WINDOW 4
+#endif
+
+/**
+ * @brief Number of out-of-order frames the receiver buffers until the gap is filled.
+ */
+#ifndef MU_RL_RX_REORDER
+#define MU_RL_RX_REORDER 4
+#endif
+
+/**
+ * @brief Number of peers whose sequence state is tracked at the same time.
+ */
+#ifndef MU_RL_MAX_PEERS
+#define MU_RL_MAX_PEERS 4
+#endif
+
+static constexpr uint8_t MU_RL_HEADER_LEN = 8;                                   //!< Link header bytes per frame
+static constexpr uint8_t MU_RL_MAX_DATA_LEN = MU_LAYER_PAYLOAD_LEN - MU_RL_HEADER_LEN; //!< Max user bytes per frame
+static constexpr uint8_t MU_RL_BROADCAST_NODE = 0xFF;                            //!< Reserved; not a valid node ID
+
+static constexpr uint32_t MU_RL_INITIAL_RTO_MS = 500;  //!< Retransmission timeout before the first RTT sample
+static constexpr uint32_t MU_RL_MIN_RTO_MS = 100;      //!< Lower bound of the retransmission timeout
+static constexpr uint32_t MU_RL_MAX_RTO_MS = 4000;     //!< Upper bound of the retransmission timeout
+static constexpr uint32_t MU_RL_ACK_DELAY_MS = 30;     //!< Wait for reverse traffic before sending a bare ACK
+static constexpr uint8_t MU_RL_DEFAULT_MAX_RETRIES = 5; //!< Retransmissions before a frame is reported as failed
+
+/**
+ * @enum MU_ReliableLink_EventType
+ * @brief Types of events reported by MU_ReliableLink.
+ */
+enum class MU_ReliableLink_EventType
+{
+    Delivered, //!< In-order data from a peer. pData is only valid during the callback.
+    Acked,     //!< A frame sent with Send() was delivered to the peer (cumulatively acknowledged).
+    Failed     //!< A frame sent with Send() exhausted its retransmissions. Later frames to the peer are
+               //!< renumbered in a new session and resent; one whose ACK was lost may be delivered twice.
+};
+
+/**
+ * @struct MU_ReliableLink_Event
+ * @brief Event passed to the MU_ReliableLink callback.
+ */
+struct MU_ReliableLink_Event
+{
+    MU_ReliableLink_EventType type; //!< Type of event.
+    uint8_t peer;                   //!< Node ID of the remote peer.
+    uint8_t seq;                    //!< Sequence number of the frame.
+    const uint8_t *pData;           //!< Received data (Delivered only).
+    uint8_t len;                    //!< Length of pData.
+};
+
+/**
+ * @typedef MU_ReliableLink_Callback
+ * @brief Callback function type for MU_ReliableLink events.
+ */
+typedef void (*MU_ReliableLink_Callback)(const MU_ReliableLink_Event &event);
+
+/**
+ * @struct MU_ReliableLink_Stats
+ * @brief Counters of the reliable link.
+ */
+struct MU_ReliableLink_Stats
+{
+    uint32_t framesSent;      //!< Data frames handed to the modem, retransmissions included.
+    uint32_t retransmissions; //!< Data frames sent again after a timeout.
+    uint32_t framesAcked;     //!< Data frames cumulatively acknowledged by peers.
+    uint32_t framesFailed;    //!< Data frames given up after MaxRetries.
+    uint32_t duplicates;      //!< Received data frames dropped as duplicates.
+    uint32_t acksSent;        //!< ACK-only frames sent.
+    uint32_t srttMs;          //!< Smoothed round trip time of the most recently sampled peer.
+};
+
+/**
+ * @class MU_ReliableLink
+ * @brief Reliable transport layer for MU_Modem.
+ *
+ * Peers are identified by a one-byte node ID chosen by the application and carried
+ * in the link header, so the modem's destination/group settings must let every peer
+ * hear the frames. Attach the layer with MU_Modem::AttachLayer(); link frames are
+ * consumed by the layer and never reach the application's modem callback.
+ */
+class MU_ReliableLink : public MU_Modem_Layer
+{
+public:
+    MU_ReliableLink();
+
+    /**
+     * @brief Initializes the link.
+     * @param modem The driver to transmit through. The layer is attached to it.
+     * @param nodeId Own node ID (0x00-0xFE).
+     * @param pCallback Callback for delivered data and send results.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if nodeId is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t nodeId, MU_ReliableLink_Callback pCallback);
+
+    /**
+     * @brief Queues data for reliable, in-order delivery to a peer.
+     * The data is copied, so the buffer may be reused when the call returns.
+     * @param peer Node ID of the destination.
+     * @param pData Data to send.
+     * @param len Length of the data (1 to MU_RL_MAX_DATA_LEN, less the driver's framing overhead
+     * when encryption or the link tag is enabled; see MU_Modem::GetMaxPayloadLen()).
+     * @return MU_Modem_Error::Ok if accepted, MU_Modem_Error::Busy if the window is full,
+     * MU_Modem_Error::InvalidArg for bad arguments.
+     */
+    MU_Modem_Error Send(uint8_t peer, const uint8_t *pData, uint8_t len);
+
+    /**
+     * @brief Returns the number of frames that can be passed to Send() right now.
+     */
+    uint8_t GetFreeSlots() const;
+
+    /**
+     * @brief Sets how often a frame is retransmitted before it is reported as failed.
+     * @param maxRetries Number of retransmissions after the first attempt.
+     */
+    void SetMaxRetries(uint8_t maxRetries) { m_maxRetries = maxRetries; }
+
+    /**
+     * @brief Returns the current retransmission timeout towards a peer.
+     * @param peer Node ID of the peer.
+     * @return Timeout in ms, MU_RL_INITIAL_RTO_MS if the peer is unknown.
+     */
+    uint32_t GetRto(uint8_t peer) const;
+
+    /**
+     * @brief Returns the link counters.
+     */
+    const MU_ReliableLink_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the link counters.
+     */
+    void ResetStats() { m_stats = MU_ReliableLink_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+
+private:
+    struct Peer
+    {
+        bool used;
+        uint8_t node;
+        uint8_t txSession;     // Random tag of our sequence space towards this peer
+        uint8_t rxSession;     // Peer's current tag (0 = not seen yet)
+        uint8_t rxPrevSession; // Peer's replaced tag; late frames carrying it are ignored
+        bool txResync;         // txSession was replaced after a failure, not because we lost state
+        uint8_t txNextSeq;     // Sequence number of the next new frame to this peer
+        uint8_t rxNextSeq;     // Next in-order sequence number expected from this peer
+        bool ackPending;       // Peer sent data we have not acknowledged yet
+        uint32_t ackDueAt;     // When to send a bare ACK if no reverse traffic appears
+        uint32_t srtt;         // Smoothed RTT (0 = no sample yet)
+        uint32_t rttvar;       // RTT variation
+        uint32_t rto;          // Current retransmission timeout
+        uint32_t lastActive;
+    };
+
+    struct TxSlot
+    {
+        bool used;
+        bool queued;        // Buffer is owned by the modem queue until TxComplete/TxFailed
+        bool sent;          // Timer running
+        bool acked;         // Acknowledged while still queued; free on TxComplete
+        bool sacked;        // Selectively acknowledged: buffered by the peer, not retransmitted
+        bool retransmitted; // Karn's rule: no RTT sample from retransmitted frames
+        uint8_t peerIndex;
+        uint8_t retries;
+        uint8_t len;
+        uint32_t order;     // Send() order, used to renumber after a session restart
+        uint32_t sentAt;
+        uint32_t rto;
+        uint8_t buf[MU_MAX_PAYLOAD_LEN];
+    };
+
+    struct RxSlot
+    {
+        bool used;
+        uint8_t peerIndex;
+        uint8_t seq;
+        uint8_t len;
+        uint8_t buf[MU_RL_MAX_DATA_LEN];
+    };
+
+    int8_t m_FindPeer(uint8_t node) const;
+    int8_t m_GetPeer(uint8_t node);
+    void m_FillHeader(uint8_t *pFrame, uint8_t flags, uint8_t peerIndex);
+    void m_Transmit(TxSlot &slot);
+    void m_SendAck(uint8_t peerIndex);
+    void m_RestartSession(uint8_t peerIndex, bool resync);
+    void m_OnAck(uint8_t peerIndex, uint8_t ack, uint8_t sack);
+    void m_OnData(uint8_t peerIndex, uint8_t seq, const uint8_t *pData, uint8_t len);
+    void m_UpdateRto(Peer &peer, uint32_t rttMs);
+    void m_Notify(MU_ReliableLink_EventType type, uint8_t peer, uint8_t seq, const uint8_t *pData, uint8_t len);
+
+    MU_Modem *m_pModem;
+    MU_ReliableLink_Callback m_pCallback;
+    uint8_t m_nodeId;
+    uint8_t m_maxRetries;
+    Peer m_peers[MU_RL_MAX_PEERS];
+    TxSlot m_tx[MU_RL_TX_WINDOW];
+    RxSlot m_rx[MU_RL_RX_REORDER];
+    uint8_t m_ackBuf[MU_RL_HEADER_LEN];
+    bool m_ackQueued;
+    uint32_t m_txOrder;
+    MU_ReliableLink_Stats m_stats;
+};
@@ -0,0 +1,211 @@
+//
+// MU_Tdma.cpp
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+//
+
+#include "MU_Tdma.h"
+
+// --- Sync Frame Layout ---
+// [0] MU_PROTO_TDMA
+// [1] Superframe counter
+// [2] Slots per superframe
+// [3..4] Slot length [ms], big endian
+static constexpr uint8_t TDMA_OFS_COUNTER = 1;
+static constexpr uint8_t TDMA_OFS_SLOTS = 2;
+static constexpr uint8_t TDMA_OFS_SLOT_MS = 3;
+
+// Host UART: "@DTxx" + payload + CRLF at 10 bits per byte
+static constexpr uint8_t TDMA_DT_COMMAND_BYTES = 7;
+
+MU_Tdma::MU_Tdma()
+    : m_pModem(nullptr), m_config(), m_slot(0), m_slotCount(0), m_slotMs(0), m_synced(false), m_pending(false),
+      m_gateHeld(false), m_superframe(0), m_epochUs(0), m_lastSyncUs(0), m_frame(), m_stats()
+{
+}
+
+MU_Modem_Error MU_Tdma::begin(MU_Modem &modem, uint8_t slot, const MU_Tdma_Config &config)
+{
+    if (config.slotCount < 2 || slot >= config.slotCount || config.slotMs == 0 || config.guardMs >= config.slotMs ||
+        (uint32_t)config.slotCount * config.slotMs > 0xFFFFFFFFUL / 2000)
+        return MU_Modem_Error::InvalidArg;
+
+    if (m_pModem && m_pModem != &modem)
+        m_pModem->DetachLayer(this);
+
+    m_pModem = &modem;
+    m_config = config;
+    m_slot = slot;
+    m_slotCount = config.slotCount;
+    m_slotMs = config.slotMs;
+    m_pending = false;
+    m_gateHeld = false;
+    m_superframe = 0;
+    m_stats = MU_Tdma_Stats();
+
+    // The coordinator owns the timing; its first superframe starts on the next Work()
+    m_synced = (slot == MU_TDMA_COORDINATOR_SLOT);
+    m_epochUs = micros() - m_SuperframeUs();
+    m_lastSyncUs = micros();
+
+    m_frame[0] = MU_PROTO_TDMA;
+    m_frame[TDMA_OFS_SLOTS] = m_slotCount;
+    m_frame[TDMA_OFS_SLOT_MS] = (uint8_t)(m_slotMs >> 8);
+    m_frame[TDMA_OFS_SLOT_MS + 1] = (uint8_t)m_slotMs;
+
+    return modem.AttachLayer(this);
+}
+
+uint32_t MU_Tdma::GetTimeToSlotMs() const
+{
+    if (!m_synced || !m_pModem)
+        return 0;
+
+    uint32_t slotUs = (uint32_t)m_slotMs * 1000;
+    uint32_t elapsed = m_Elapsed(micros());
+    uint32_t slotStart = (uint32_t)(m_slot % m_slotCount) * slotUs;
+    if (elapsed >= slotStart && elapsed < slotStart + slotUs)
+        return 0;
+    uint32_t waitUs = (slotStart + m_SuperframeUs() - elapsed) % m_SuperframeUs();
+    return (waitUs + 999) / 1000;
+}
+
+uint32_t MU_Tdma::m_Elapsed(uint32_t nowUs) const
+{
+    // A fresh sync may place the epoch slightly in the future
+    uint32_t superframeUs = m_SuperframeUs();
+    int32_t diff = (int32_t)(nowUs - m_epochUs);
+    if (diff >= 0)
+        return (uint32_t)diff % superframeUs;
+    return (superframeUs - (uint32_t)(-diff) % superframeUs) % superframeUs;
+}
+
+uint32_t MU_Tdma::m_StartDelayUs(uint8_t wireLen) const
+{
+    // From handing the frame to the driver until it starts on air
+    uint32_t baud = m_pModem->GetBaudRate() ? m_pModem->GetBaudRate() : MU_DEFAULT_BAUDRATE;
+    return ((uint32_t)wireLen + TDMA_DT_COMMAND_BYTES) * 10000000UL / baud + m_config.txLatencyUs;
+}
+
+void MU_Tdma::m_Advance(uint32_t nowUs)
+{
+    // Keep the epoch within one superframe of now, so differences never wrap
+    uint32_t superframeUs = m_SuperframeUs();
+    uint32_t behind = nowUs - m_epochUs;
+    if ((int32_t)behind >= (int32_t)superframeUs)
+    {
+        uint32_t frames = behind / superframeUs;
+        m_epochUs += frames * superframeUs;
+        m_superframe = (uint8_t)(m_superframe + frames);
+    }
+}
+
+// --- MU_Modem_Layer ---
+
+bool MU_Tdma::OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event)
+{
+    if (event.type == MU_Modem_Response::TxComplete || event.type == MU_Modem_Response::TxFailed)
+    {
+        if (m_pending && event.pPayload == m_frame)
+        {
+            m_pending = false;
+            return true;
+        }
+        return false;
+    }
+
+    if (event.type != MU_Modem_Response::DataReceived || event.payloadLen < MU_TDMA_SYNC_LEN ||
+        event.pPayload[0] != MU_PROTO_TDMA)
+        return false;
+
+    if (m_slot == MU_TDMA_COORDINATOR_SLOT)
+        return true; // A second coordinator; ours keeps its own timing
+
+    uint8_t slotCount = event.pPayload[TDMA_OFS_SLOTS];
+    uint16_t slotMs = (uint16_t)((event.pPayload[TDMA_OFS_SLOT_MS] << 8) | event.pPayload[TDMA_OFS_SLOT_MS + 1]);
+    if (slotCount < 2 || slotMs <= m_config.guardMs || (uint32_t)slotCount * slotMs > 0xFFFFFFFFUL / 2000)
+        return true;
+
+    // The coordinator queued the sync frame at the superframe start: walk back from its start on air
+    uint32_t airStartUs;
+    if (modem.EstimateAirTime(event, &airStartUs, nullptr) != MU_Modem_Error::Ok)
+        return true;
+    uint32_t epochUs = airStartUs - m_StartDelayUs(event.wireLen);
+
+    if (m_synced && slotCount == m_slotCount && slotMs == m_slotMs)
+    {
+        // Correction relative to the superframe boundary we expected closest to the new one
+        uint32_t superframeUs = m_SuperframeUs();
+        uint32_t phase = (uint32_t)(epochUs - m_epochUs) % superframeUs;
+        int32_t offset = (phase > superframeUs / 2) ? -(int32_t)(superframeUs - phase) : (int32_t)phase;
+        uint32_t magnitude = (offset < 0) ? (uint32_t)-offset : (uint32_t)offset;
+        m_stats.lastOffsetUs = offset;
+        if (magnitude > m_stats.maxOffsetUs)
+            m_stats.maxOffsetUs = magnitude;
+    }
+
+    m_slotCount = slotCount;
+    m_slotMs = slotMs;
+    m_epochUs = epochUs;
+    m_superframe = event.pPayload[TDMA_OFS_COUNTER];
+    m_lastSyncUs = event.timestampUs;
+    m_synced = true;
+    m_stats.syncReceived++;
+    return true;
+}
+
+void MU_Tdma::OnModemWork(MU_Modem &modem)
+{
+    if (!m_pModem)
+        return;
+
+    uint32_t now = micros();
+    if (m_slot != MU_TDMA_COORDINATOR_SLOT)
+    {
+        // The product overflows 32 bits for long superframes; beyond half the micros() range it cannot be timed anyway
+        uint64_t lostUs = (uint64_t)m_config.maxMissedSyncs * m_SuperframeUs();
+        if (lostUs > 0x7FFFFFFFUL)
+            lostUs = 0x7FFFFFFFUL;
+        if (m_synced && (uint32_t)(now - m_lastSyncUs) > (uint32_t)lostUs)
+        {
+            m_synced = false;
+            m_stats.syncLost++;
+        }
+        if (m_synced)
+            m_Advance(now);
+        return;
+    }
+
+    // Coordinator: open each superframe with a sync frame
+    uint8_t before = m_superframe;
+    m_Advance(now);
+    if (m_superframe == before || m_pending)
+        return;
+
+    m_frame[TDMA_OFS_COUNTER] = m_superframe;
+    if (modem.TransmitDataAsync(m_frame, MU_TDMA_SYNC_LEN, false, MU_Modem_Priority::UrgentTx) == MU_Modem_Error::Ok)
+    {
+        m_pending = true;
+        m_stats.syncSent++;
+    }
+}
+
+bool MU_Tdma::OnModemTxGate(MU_Modem &modem, uint8_t wireLen, uint32_t aheadUs)
+{
+    if (!m_synced)
+        return true;
+
+    // The frame must be on air and done a guard time before the own slot closes,
+    // behind any frames still pipelined in the modem
+    uint32_t slotUs = (uint32_t)m_slotMs * 1000;
+    uint32_t elapsed = m_Elapsed(micros());
+    uint32_t slotStart = (uint32_t)(m_slot % m_slotCount) * slotUs;
+    uint32_t needUs = aheadUs + m_StartDelayUs(wireLen) + modem.GetFrameAirtimeUs(wireLen) + (uint32_t)m_config.guardMs * 1000;
+    bool open = elapsed >= slotStart && elapsed - slotStart + needUs <= slotUs;
+
+    if (!open && !m_gateHeld)
+        m_stats.gateHolds++;
+    m_gateHeld = !open;
+    return open;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file MU_Tdma.h
+ * @brief Slotted channel access with over-the-air time synchronization.
+ *
+ * A coordinator (slot 0) opens every superframe with a short sync frame. The
+ * other nodes re-anchor their superframe timing on the receive timestamp of
+ * the sync frame (taken at the first byte of its *DR response), and the
+ * driver hands frames queued with TransmitDataAsync() to the modem only while
+ * they fit into the node's own slot. Nodes reporting at the same cadence then stop colliding in LBT and
+ * each node's access delay is bounded by one superframe.
+ */
+//
+// (c) 2026 CircuitDesign,Inc.
+// Interface driver for MU-3/MU-4 (FSK modem manufactured by Circuit Design)
+
+#pragma once
+#include "MU_Modem.h"
+
+static constexpr uint8_t MU_TDMA_SYNC_LEN = 5;          //!< Sync frame payload bytes (before codec overhead)
+static constexpr uint8_t MU_TDMA_COORDINATOR_SLOT = 0;  //!< Slot of the coordinator
+
+/**
+ * @struct MU_Tdma_Config
+ * @brief Superframe layout and timing margins.
+ */
+struct MU_Tdma_Config
+{
+    uint8_t slotCount = 8;          //!< Slots per superframe (coordinator only; nodes take it from the sync frame).
+    uint16_t slotMs = 250;          //!< Slot length [ms] (coordinator only; nodes take it from the sync frame).
+    uint16_t guardMs = 15;          //!< Frames must end on air this long before their slot ends [ms].
+    uint32_t txLatencyUs = 6000;    //!< LBT listen time and modem processing before a frame goes on air [us] (UART transfer is added).
+    uint8_t maxMissedSyncs = 4;     //!< Superframes without sync after which a node falls back to unslotted access (at most ~35 min).
+};
+
+/**
+ * @struct MU_Tdma_Stats
+ * @brief Counters of the slotted access.
+ */
+struct MU_Tdma_Stats
+{
+    uint32_t syncSent;     //!< Sync frames queued (coordinator).
+    uint32_t syncReceived; //!< Sync frames received (nodes).
+    uint32_t syncLost;     //!< Times a node lost synchronization.
+    uint32_t gateHolds;    //!< Times a queued frame was held outside the node's slot.
+    int32_t lastOffsetUs;  //!< Clock correction applied with the last sync frame [us].
+    uint32_t maxOffsetUs;  //!< Largest absolute correction [us].
+};
+
+/**
+ * @class MU_Tdma
+ * @brief Time division access layer for MU_Modem.
+ *
+ * Only frames queued with TransmitDataAsync() are scheduled; TransmitData() and commands are
+ * not. Until a node has received its first sync frame, and after maxMissedSyncs superframes
+ * without one, its frames are sent immediately as without this layer. Each slot should be
+ * long enough for the largest frame plus guardMs, and slot 0 also carries the sync frame.
+ */
+class MU_Tdma : public MU_Modem_Layer
+{
+public:
+    MU_Tdma();
+
+    /**
+     * @brief Initializes slotted access and attaches the layer to the driver.
+     * @param modem The driver.
+     * @param slot Own slot, below config.slotCount. MU_TDMA_COORDINATOR_SLOT makes this node the coordinator.
+     * @param config Superframe layout and margins.
+     * @return MU_Modem_Error::Ok on success, MU_Modem_Error::InvalidArg if the layout or the slot is invalid.
+     */
+    MU_Modem_Error begin(MU_Modem &modem, uint8_t slot, const MU_Tdma_Config &config = MU_Tdma_Config());
+
+    /**
+     * @brief Returns true while the superframe timing is known (always true on the coordinator).
+     */
+    bool IsSynchronized() const { return m_synced; }
+
+    /**
+     * @brief Returns the time until the own slot opens [ms] (0 inside the slot or when unsynchronized).
+     */
+    uint32_t GetTimeToSlotMs() const;
+
+    /**
+     * @brief Returns the slotted access counters.
+     */
+    const MU_Tdma_Stats &GetStats() const { return m_stats; }
+
+    /**
+     * @brief Clears the slotted access counters.
+     */
+    void ResetStats() { m_stats = MU_Tdma_Stats(); }
+
+    // MU_Modem_Layer overrides
+    virtual bool OnModemEvent(MU_Modem &modem, const MU_Modem_Event &event) override;
+    virtual void OnModemWork(MU_Modem &modem) override;
+    virtual bool OnModemTxGate(MU_Modem &modem, uint8_t wireLen, uint32_t aheadUs) override;
+
+private:
+    uint32_t m_SuperframeUs() const { return (uint32_t)m_slotCount * m_slotMs * 1000; }
+    uint32_t m_Elapsed(uint32_t nowUs) const;
+    uint32_t m_StartDelayUs(uint8_t wireLen) const;
+    void m_Advance(uint32_t nowUs);
+
+    MU_Modem *m_pModem;
+    MU_Tdma_Config m_config;
+    uint8_t m_slot;
+    uint8_t m_slotCount;
+    uint16_t m_slotMs;
+    bool m_synced;
+    bool m_pending;         // m_frame is queued in the modem (coordinator)
+    bool m_gateHeld;        // Last gate decision was a hold (counts each hold once)
+    uint8_t m_superframe;   // Superframe counter carried in the sync frame
+    uint32_t m_epochUs;     // micros() at the start of the current superframe
+    uint32_t m_lastSyncUs;  // micros() of the last sync frame (nodes)
+    uint8_t m_frame[MU_TDMA_SYNC_LEN];
+    MU_Tdma_Stats m_stats;
+};